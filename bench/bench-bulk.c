@@ -0,0 +1,135 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-bulk.c compare the _n bulk functions with single-item loops */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static void bench_loop(const char *mode, unsigned options, void **items,
+		       size_t total, size_t batch)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 0, NULL, options);
+	uint64_t start;
+	uintptr_t sum = 0;
+	size_t i, j;
+
+	if (!d) {
+		fprintf(stderr, "deque_init_options failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = bench_now_ns();
+	for (i = 0; i < total; i += batch) {
+		for (j = 0; j < batch; ++j) {
+			deque_push(d, items[j]);
+		}
+	}
+	bench_report(mode, "push", total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (i = 0; i < total; i += batch) {
+		for (j = 0; j < batch; ++j) {
+			sum += (uintptr_t)deque_shift(d);
+		}
+	}
+	bench_report(mode, "shift", total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (i = 0; i < total; i += batch) {
+		for (j = 0; j < batch; ++j) {
+			deque_unshift(d, items[j]);
+		}
+	}
+	bench_report(mode, "unshift", total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (i = 0; i < total; i += batch) {
+		for (j = 0; j < batch; ++j) {
+			sum += (uintptr_t)deque_pop(d);
+		}
+	}
+	bench_report(mode, "pop", total, total, bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_free(d);
+}
+
+static void bench_bulk(const char *mode, unsigned options, void **items,
+		       void **out, size_t total, size_t batch)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 0, NULL, options);
+	uint64_t start;
+	uintptr_t sum = 0;
+	size_t i;
+
+	if (!d) {
+		fprintf(stderr, "deque_init_options failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = bench_now_ns();
+	for (i = 0; i < total; i += batch) {
+		deque_push_n(d, items, batch);
+	}
+	bench_report(mode, "push_n", total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (i = 0; i < total; i += batch) {
+		deque_shift_n(d, out, batch);
+		sum += (uintptr_t)out[0];
+	}
+	bench_report(mode, "shift_n", total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (i = 0; i < total; i += batch) {
+		deque_unshift_n(d, items, batch);
+	}
+	bench_report(mode, "unshift_n", total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (i = 0; i < total; i += batch) {
+		deque_pop_n(d, out, batch);
+		sum += (uintptr_t)out[0];
+	}
+	bench_report(mode, "pop_n", total, total, bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_free(d);
+}
+
+int main(int argc, char **argv)
+{
+	size_t total = bench_arg_size(argc, argv, 1, 10UL * 1000 * 1000);
+	size_t batch = bench_arg_size(argc, argv, 2, 64);
+	void **items = NULL;
+	void **out = NULL;
+	size_t i;
+
+	if (!batch) {
+		batch = 1;
+	}
+	total -= (total % batch);
+
+	items = (void **)calloc(batch, sizeof(void *));
+	out = (void **)calloc(batch, sizeof(void *));
+	if (!items || !out) {
+		fprintf(stderr, "calloc failed\n");
+		return EXIT_FAILURE;
+	}
+	for (i = 0; i < batch; ++i) {
+		items[i] = &items[i];
+	}
+
+	bench_loop("bulk-linear", 0, items, total, batch);
+	bench_bulk("bulk-linear", 0, items, out, total, batch);
+	bench_loop("bulk-ring", Deque_option_ring, items, total, batch);
+	bench_bulk("bulk-ring", Deque_option_ring, items, out, total, batch);
+
+	free(out);
+	free(items);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-erase.c removing from the middle: erase_at, or via a second deque */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static void fill(struct deque *d, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; ++i) {
+		if (!deque_push(d, (void *)(uintptr_t)(i + 1))) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+/* without erase_at: shift the items before index over to a second deque,
+   drop the one, then unshift them back */
+static void *erase_by_shifting(struct deque *d, struct deque *tmp,
+			       size_t index)
+{
+	void *erased = NULL;
+	size_t i;
+
+	for (i = 0; i < index; ++i) {
+		deque_push(tmp, deque_shift(d));
+	}
+	erased = deque_shift(d);
+	while (deque_size(tmp)) {
+		deque_unshift(d, deque_pop(tmp));
+	}
+	return erased;
+}
+
+static void bench_erase(const char *variant, unsigned options, size_t n,
+			size_t rounds)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 0, NULL, options);
+	struct deque *tmp = deque_new();
+	uintptr_t sum = 0;
+	uint64_t start;
+	size_t r, x = 12345;
+
+	if (!d || !tmp) {
+		fprintf(stderr, "deque_init_options failed\n");
+		exit(EXIT_FAILURE);
+	}
+	fill(d, n);
+
+	/* each round erases one item and inserts it again, at random */
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		x = (x * 1103515245 + 12345) % n;
+		sum += (uintptr_t)deque_erase_at(d, x);
+		deque_insert_at(d, x, (void *)(uintptr_t)r);
+	}
+	bench_report("erase_at+insert_at", variant, n, 2 * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		x = (x * 1103515245 + 12345) % n;
+		sum += (uintptr_t)erase_by_shifting(d, tmp, x);
+		deque_push(d, (void *)(uintptr_t)r);
+	}
+	bench_report("shift-erase-unshift+push", variant, n, 2 * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		sum += deque_erase_range(d, n / 4, n / 4 + 8);
+		fill(d, 8);
+	}
+	bench_report("erase_range-8+push", variant, n, 2 * rounds,
+		     bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_free(tmp);
+	deque_free(d);
+}
+
+int main(int argc, char **argv)
+{
+	size_t max_n = bench_arg_size(argc, argv, 1, 64 * 1024);
+	size_t min_ops = bench_arg_size(argc, argv, 2, 200UL * 1000 * 1000);
+	size_t n, rounds;
+
+	for (n = 16; n <= max_n; n *= 16) {
+		/* each round moves up to n/2 items */
+		rounds = (min_ops / n) ? (min_ops / n) : 1;
+		bench_erase("linear", 0, n, rounds);
+		bench_erase("ring", Deque_option_ring, n, rounds);
+	}
+
+	return EXIT_SUCCESS;
+}
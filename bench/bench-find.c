@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-find.c searching for a pointer: for_each callback, or deque_find */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct find_context {
+	const void *item;
+	size_t index;
+};
+
+static int find_each(struct deque *d, void *each, void *context)
+{
+	struct find_context *ctx = (struct find_context *)context;
+
+	(void)d;
+	if (each == ctx->item) {
+		return 1;
+	}
+	++ctx->index;
+	return 0;
+}
+
+static void bench_find(const char *variant, unsigned options, size_t n,
+		       size_t rounds)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 0, NULL, options);
+	struct find_context ctx;
+	uint64_t start;
+	size_t r, i, found = 0;
+
+	if (!d) {
+		fprintf(stderr, "deque_init_options failed\n");
+		exit(EXIT_FAILURE);
+	}
+	/* from both ends, thus a ring is wrapped */
+	for (i = 0; i < n; ++i) {
+		if (!((i & 1) ? deque_push(d, d) : deque_unshift(d, d))) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* the worst case, as for a dedup check: not found */
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		ctx.item = &ctx;
+		ctx.index = 0;
+		deque_for_each(d, find_each, &ctx);
+		found += ctx.index;
+	}
+	bench_report("for_each-miss", variant, n, n * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		found += deque_find(d, &ctx);
+	}
+	bench_report("find-miss", variant, n, n * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		found += deque_find_last(d, &ctx);
+	}
+	bench_report("find_last-miss", variant, n, n * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		found += deque_count(d, d);
+	}
+	bench_report("count", variant, n, n * rounds, bench_now_ns() - start);
+
+	bench_sink += found;
+	deque_free(d);
+}
+
+int main(int argc, char **argv)
+{
+	size_t max_n = bench_arg_size(argc, argv, 1, 1000 * 1000);
+	size_t min_ops = bench_arg_size(argc, argv, 2, 200UL * 1000 * 1000);
+	size_t n, rounds;
+
+	for (n = 16; n <= max_n; n *= 16) {
+		rounds = (min_ops / n) ? (min_ops / n) : 1;
+		bench_find("linear", 0, n, rounds);
+		bench_find("ring", Deque_option_ring, n, rounds);
+	}
+
+	return EXIT_SUCCESS;
+}
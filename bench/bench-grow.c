@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-grow.c growth by realloc compared to malloc, copy, free */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "eembed.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static void bench_grow(const char *mode, const char *variant,
+		       struct eembed_allocator *ea, unsigned options,
+		       size_t total)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 0, ea, options);
+	uint64_t start;
+	size_t i;
+
+	if (!d) {
+		fprintf(stderr, "deque_init_options failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = bench_now_ns();
+	for (i = 0; i < total; ++i) {
+		if (!deque_push(d, d)) {
+			fprintf(stderr, "%s %s: push %lu failed\n", mode,
+				variant, (unsigned long)i);
+			break;
+		}
+	}
+	bench_report(mode, variant, total, i, bench_now_ns() - start);
+
+	deque_free(d);
+}
+
+int main(int argc, char **argv)
+{
+	size_t total = bench_arg_size(argc, argv, 1, 100UL * 1000 * 1000);
+	struct eembed_allocator *ea = eembed_global_allocator;
+	struct eembed_allocator no_realloc;
+
+	/* the same allocator, but without the realloc hook */
+	no_realloc = *ea;
+	no_realloc.realloc = NULL;
+
+	bench_grow("grow-linear", "realloc", ea, 0, total);
+	bench_grow("grow-linear", "malloc-copy", &no_realloc, 0, total);
+	bench_grow("grow-ring", "realloc", ea, Deque_option_ring, total);
+	bench_grow("grow-ring", "malloc-copy", &no_realloc, Deque_option_ring,
+		   total);
+
+	return EXIT_SUCCESS;
+}
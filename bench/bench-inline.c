@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-inline.c small structs by value, compared to malloc per item */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "deque-inline.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define Bench_max_message 64
+
+struct bench_message {
+	uint64_t id;
+	unsigned char payload[Bench_max_message - sizeof(uint64_t)];
+};
+
+static int sum_pointed(struct deque *d, void *each, void *context)
+{
+	(void)d;
+	*(uint64_t *)context += ((struct bench_message *)each)->id;
+	return 0;
+}
+
+static int sum_inline(struct deque_inline *d, void *each, void *context)
+{
+	(void)d;
+	*(uint64_t *)context += ((struct bench_message *)each)->id;
+	return 0;
+}
+
+/* each message is malloc'd, and the pointer is queued */
+static void bench_pointers(size_t msg_size, size_t total)
+{
+	struct deque *d = deque_new();
+	struct bench_message *m;
+	char variant[40];
+	uint64_t start, sum = 0;
+	size_t i;
+
+	if (!d) {
+		fprintf(stderr, "deque_new failed\n");
+		exit(EXIT_FAILURE);
+	}
+	sprintf(variant, "malloc-pointer-%lu", (unsigned long)msg_size);
+
+	start = bench_now_ns();
+	for (i = 0; i < total; ++i) {
+		m = (struct bench_message *)malloc(msg_size);
+		if (!m || !deque_push(d, m)) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+		m->id = i;
+	}
+	bench_report("fill", variant, total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	deque_for_each(d, sum_pointed, &sum);
+	bench_report("scan", variant, total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	while ((m = (struct bench_message *)deque_shift(d)) != NULL) {
+		sum += m->id;
+		free(m);
+	}
+	bench_report("drain", variant, total, total, bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_free(d);
+}
+
+/* each message is copied by value in to the data_space */
+static void bench_inline(size_t msg_size, size_t total)
+{
+	struct deque_inline *d = deque_inline_new(msg_size);
+	struct bench_message m;
+	char variant[40];
+	uint64_t start, sum = 0;
+	size_t i;
+
+	if (!d) {
+		fprintf(stderr, "deque_inline_new failed\n");
+		exit(EXIT_FAILURE);
+	}
+	sprintf(variant, "deque_inline-%lu", (unsigned long)msg_size);
+	memset(&m, 0x00, sizeof(struct bench_message));
+
+	start = bench_now_ns();
+	for (i = 0; i < total; ++i) {
+		m.id = i;
+		if (!deque_inline_push(d, &m)) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	bench_report("fill", variant, total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	deque_inline_for_each(d, sum_inline, &sum);
+	bench_report("scan", variant, total, total, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	while (deque_inline_shift(d, &m)) {
+		sum += m.id;
+	}
+	bench_report("drain", variant, total, total, bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_inline_free(d);
+}
+
+int main(int argc, char **argv)
+{
+	size_t total = bench_arg_size(argc, argv, 1, 10UL * 1000 * 1000);
+	size_t sizes[] = { 16, 32, 64 };
+	size_t i;
+
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+		bench_pointers(sizes[i], total);
+		bench_inline(sizes[i], total);
+	}
+
+	return EXIT_SUCCESS;
+}
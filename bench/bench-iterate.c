@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-iterate.c ways to read every item: callback, peek, cursor, spans */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int sum_each(struct deque *d, void *each, void *context)
+{
+	(void)d;
+	*(uintptr_t *)context += (uintptr_t)each;
+	return 0;
+}
+
+static void bench_iterate(const char *variant, unsigned options, size_t n,
+			  size_t rounds)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 0, NULL, options);
+	struct deque_cursor c;
+	void **a, **b, **slot;
+	size_t a_len, b_len, r, i;
+	uintptr_t sum = 0;
+	uint64_t start;
+
+	if (!d) {
+		fprintf(stderr, "deque_init_options failed\n");
+		exit(EXIT_FAILURE);
+	}
+	/* from both ends, thus a ring is wrapped */
+	for (i = 0; i < n; ++i) {
+		if (!((i & 1) ? deque_push(d, d) : deque_unshift(d, d))) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		deque_for_each(d, sum_each, &sum);
+	}
+	bench_report("for_each", variant, n, n * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			sum += (uintptr_t)deque_peek_bottom(d, i);
+		}
+	}
+	bench_report("peek_bottom", variant, n, n * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		deque_cursor_init(&c, d, 0);
+		while ((slot = deque_cursor_next(&c)) != NULL) {
+			sum += (uintptr_t)*slot;
+		}
+	}
+	bench_report("cursor", variant, n, n * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		deque_as_spans(d, &a, &a_len, &b, &b_len);
+		for (i = 0; i < a_len; ++i) {
+			sum += (uintptr_t)a[i];
+		}
+		for (i = 0; i < b_len; ++i) {
+			sum += (uintptr_t)b[i];
+		}
+	}
+	bench_report("spans", variant, n, n * rounds, bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_free(d);
+}
+
+int main(int argc, char **argv)
+{
+	size_t max_n = bench_arg_size(argc, argv, 1, 1000 * 1000);
+	size_t min_ops = bench_arg_size(argc, argv, 2, 50UL * 1000 * 1000);
+	size_t n, rounds;
+
+	for (n = 16; n <= max_n; n *= 16) {
+		rounds = (min_ops / n) ? (min_ops / n) : 1;
+		bench_iterate("linear", 0, n, rounds);
+		bench_iterate("ring", Deque_option_ring, n, rounds);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-layout.c struct and data_space layout, with perf counters */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* many deques, each touched once in turn, thus each op misses on its
+   struct: one line if the hot fields fit in one, or two */
+static void bench_many(size_t n, size_t rounds, struct bench_perf *perf)
+{
+	struct deque **d = (struct deque **)malloc(sizeof(struct deque *) * n);
+	uintptr_t sum = 0;
+	uint64_t start;
+	size_t i, r, j;
+
+	if (!d) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < n; ++i) {
+		d[i] = deque_new();
+		if (!d[i]) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+		deque_push(d[i], d);
+	}
+
+	bench_perf_start(perf);
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		/* a stride which is co-prime with n, to defeat prefetch */
+		for (i = 0, j = 0; i < n; ++i, j = (j + 7919) % n) {
+			deque_push(d[j], d);
+			sum += (uintptr_t)deque_shift(d[j]);
+		}
+	}
+	bench_perf_stop(perf);
+	bench_report_perf("many-push-shift", "deque_new", n, n * rounds,
+			  bench_now_ns() - start, perf);
+
+	for (i = 0; i < n; ++i) {
+		deque_free(d[i]);
+	}
+	free(d);
+	bench_sink += sum;
+}
+
+static int is_match(struct deque *d, void *each, void *context)
+{
+	(void)d;
+	return each == context;
+}
+
+/* bulk and SIMD access to one large data_space */
+static void bench_bulk(const char *variant, unsigned options, size_t n,
+		       size_t rounds, struct bench_perf *perf)
+{
+	struct deque *d = deque_init_options(NULL, NULL, n, NULL, options);
+	void **tmp = (void **)malloc(sizeof(void *) * n);
+	uintptr_t sum = 0;
+	uint64_t start;
+	size_t i, r;
+
+	if (!d || !tmp) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < n; ++i) {
+		tmp[i] = (void *)(uintptr_t)(i + 1);
+	}
+	deque_push_n(d, tmp, n);
+
+	bench_perf_start(perf);
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		sum += deque_find(d, tmp);
+	}
+	bench_perf_stop(perf);
+	bench_report_perf("find-miss", variant, n, n * rounds,
+			  bench_now_ns() - start, perf);
+
+	bench_perf_start(perf);
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		sum += (uintptr_t)deque_for_each(d, is_match, tmp);
+	}
+	bench_perf_stop(perf);
+	bench_report_perf("for_each", variant, n, n * rounds,
+			  bench_now_ns() - start, perf);
+
+	bench_perf_start(perf);
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		sum += deque_shift_n(d, tmp, n);
+		deque_push_n(d, tmp, n);
+	}
+	bench_perf_stop(perf);
+	bench_report_perf("shift_n-push_n", variant, n, n * rounds,
+			  bench_now_ns() - start, perf);
+
+	free(tmp);
+	deque_free(d);
+	bench_sink += sum;
+}
+
+int main(int argc, char **argv)
+{
+	size_t max_n = bench_arg_size(argc, argv, 1, 1024 * 1024);
+	size_t min_ops = bench_arg_size(argc, argv, 2, 64UL * 1024 * 1024);
+	struct bench_perf perf;
+	size_t n, rounds;
+
+	if (!bench_perf_open(&perf)) {
+		fprintf(stderr, "no perf counters, times only\n");
+	}
+
+	for (n = 1024; n <= max_n; n *= 32) {
+		rounds = (min_ops / n) ? (min_ops / n) : 1;
+		bench_many(n, rounds / 8, &perf);
+		bench_bulk("default", 0, n, rounds, &perf);
+		bench_bulk("aligned", Deque_option_aligned, n, rounds, &perf);
+	}
+
+	bench_perf_close(&perf);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-mmap.c growing large deques, malloc compared to mmap */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-mmap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+static long bench_minor_faults(void)
+{
+	struct rusage ru;
+
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_minflt;
+}
+
+static void bench_mmap(const char *variant, struct eembed_allocator *ea,
+		       size_t n)
+{
+	struct deque *d = deque_new_custom_allocator(ea);
+	uintptr_t sum = 0;
+	uint64_t start;
+	long faults;
+	size_t i;
+
+	if (!d) {
+		fprintf(stderr, "deque_new_custom_allocator failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	faults = bench_minor_faults();
+	start = bench_now_ns();
+	for (i = 0; i < n; ++i) {
+		if (!deque_push(d, (void *)(uintptr_t)(i + 1))) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	bench_report("push", variant, n, n, bench_now_ns() - start);
+	printf("{\"bench\": \"push-faults\", \"variant\": \"%s\", "
+	       "\"items\": %lu, \"minor_faults\": %ld}\n", variant,
+	       (unsigned long)n, bench_minor_faults() - faults);
+
+	/* drain, and shrink each time half is unused */
+	start = bench_now_ns();
+	for (i = 0; i < n; ++i) {
+		sum += (uintptr_t)deque_shift(d);
+		if (deque_size(d) < deque_capacity(d) / 2) {
+			deque_shrink_to_fit(d);
+		}
+	}
+	bench_report("shift-shrink", variant, n, n, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	deque_free(d);
+	bench_report("free", variant, n, 1, bench_now_ns() - start);
+
+	bench_sink += sum;
+}
+
+int main(int argc, char **argv)
+{
+	size_t max_n = bench_arg_size(argc, argv, 1, 8UL * 1024 * 1024);
+	struct deque_mmap_allocator plain, thp;
+	size_t n;
+
+	deque_mmap_allocator_init(&plain, NULL, 0, 0);
+	deque_mmap_allocator_init(&thp, NULL, 0, Deque_mmap_thp);
+
+	for (n = 1024 * 1024; n <= max_n; n *= 8) {
+		bench_mmap("malloc", eembed_global_allocator, n);
+		bench_mmap("mmap", &plain.ea, n);
+		bench_mmap("mmap-thp", &thp.ea, n);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-mt.c deque_mt compared to a deque behind a single mutex */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "deque-mt.h"
+#include "bench.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* a deque behind one mutex, the simple alternative */
+struct locked_deque {
+	pthread_mutex_t lock;
+	struct deque *d;
+};
+
+struct bench_context {
+	struct deque_mt *mt;
+	struct locked_deque *locked;
+	size_t per_thread;
+};
+
+static void *mt_producer(void *arg)
+{
+	struct bench_context *ctx = (struct bench_context *)arg;
+	size_t i;
+
+	for (i = 0; i < ctx->per_thread; ++i) {
+		deque_mt_push(ctx->mt, ctx);
+	}
+	return NULL;
+}
+
+static void *mt_consumer(void *arg)
+{
+	struct bench_context *ctx = (struct bench_context *)arg;
+	size_t i = 0;
+
+	while (i < ctx->per_thread) {
+		if (deque_mt_shift(ctx->mt)) {
+			++i;
+		}
+	}
+	return NULL;
+}
+
+static void *locked_producer(void *arg)
+{
+	struct bench_context *ctx = (struct bench_context *)arg;
+	struct locked_deque *ld = ctx->locked;
+	size_t i;
+
+	for (i = 0; i < ctx->per_thread; ++i) {
+		pthread_mutex_lock(&ld->lock);
+		deque_push(ld->d, ctx);
+		pthread_mutex_unlock(&ld->lock);
+	}
+	return NULL;
+}
+
+static void *locked_consumer(void *arg)
+{
+	struct bench_context *ctx = (struct bench_context *)arg;
+	struct locked_deque *ld = ctx->locked;
+	size_t i = 0;
+	void *data;
+
+	while (i < ctx->per_thread) {
+		pthread_mutex_lock(&ld->lock);
+		data = deque_shift(ld->d);
+		pthread_mutex_unlock(&ld->lock);
+		if (data) {
+			++i;
+		}
+	}
+	return NULL;
+}
+
+/* items arrive in bursts, with pauses in between */
+static void *bursty_producer(void *arg)
+{
+	struct bench_context *ctx = (struct bench_context *)arg;
+	struct timespec pause = { 0, 100 * 1000 };
+	size_t i;
+
+	for (i = 0; i < ctx->per_thread; ++i) {
+		if ((i % 64) == 0) {
+			nanosleep(&pause, NULL);
+		}
+		deque_mt_push(ctx->mt, ctx);
+	}
+	return NULL;
+}
+
+static void *polling_consumer(void *arg)
+{
+	struct bench_context *ctx = (struct bench_context *)arg;
+	size_t i = 0;
+
+	while (i < ctx->per_thread) {
+		if (deque_mt_shift(ctx->mt)) {
+			++i;
+		} else {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void *waiting_consumer(void *arg)
+{
+	struct bench_context *ctx = (struct bench_context *)arg;
+	void *data = NULL;
+	size_t i;
+
+	for (i = 0; i < ctx->per_thread; ++i) {
+		deque_mt_shift_wait(ctx->mt, &data, -1);
+	}
+	return NULL;
+}
+
+/* the cpu time burned by a consumer polling, compared to waiting */
+static void bench_bursty(const char *variant, struct bench_context *ctx,
+			 void *(*consume)(void *))
+{
+	pthread_t threads[2];
+	uint64_t start;
+
+	start = bench_cpu_ns();
+	pthread_create(&threads[0], NULL, consume, ctx);
+	pthread_create(&threads[1], NULL, bursty_producer, ctx);
+	pthread_join(threads[0], NULL);
+	pthread_join(threads[1], NULL);
+	bench_report("bursty-1x1-cpu", variant, ctx->per_thread,
+		     ctx->per_thread, bench_cpu_ns() - start);
+}
+
+/* pairs of threads: each producer pushes, each consumer shifts */
+static void bench_pairs(const char *variant, struct bench_context *ctx,
+			size_t pairs, void *(*produce)(void *),
+			void *(*consume)(void *))
+{
+	pthread_t *threads;
+	char mode[40];
+	uint64_t start;
+	size_t i;
+
+	threads = (pthread_t *)calloc(2 * pairs, sizeof(pthread_t));
+	if (!threads) {
+		fprintf(stderr, "calloc failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = bench_now_ns();
+	for (i = 0; i < pairs; ++i) {
+		pthread_create(&threads[2 * i], NULL, consume, ctx);
+		pthread_create(&threads[(2 * i) + 1], NULL, produce, ctx);
+	}
+	for (i = 0; i < 2 * pairs; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+	sprintf(mode, "fifo-%lux%lu", (unsigned long)pairs,
+		(unsigned long)pairs);
+	bench_report(mode, variant, ctx->per_thread,
+		     2 * pairs * ctx->per_thread, bench_now_ns() - start);
+
+	free(threads);
+}
+
+int main(int argc, char **argv)
+{
+	size_t per_thread = bench_arg_size(argc, argv, 1, 1000 * 1000);
+	size_t max_pairs = bench_arg_size(argc, argv, 2, 4);
+	struct locked_deque locked;
+	struct bench_context ctx;
+	size_t pairs;
+
+	pthread_mutex_init(&locked.lock, NULL);
+	locked.d = deque_init_options(NULL, NULL, 0, NULL, Deque_option_ring);
+	ctx.mt = deque_mt_new();
+	ctx.locked = &locked;
+	ctx.per_thread = per_thread;
+	if (!locked.d || !ctx.mt) {
+		fprintf(stderr, "init failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (pairs = 1; pairs <= max_pairs; pairs *= 2) {
+		bench_pairs("deque_mt", &ctx, pairs, mt_producer, mt_consumer);
+		bench_pairs("mutex-deque", &ctx, pairs, locked_producer,
+			    locked_consumer);
+	}
+
+	ctx.per_thread = per_thread / 10;
+	bench_bursty("poll", &ctx, polling_consumer);
+	bench_bursty("wait", &ctx, waiting_consumer);
+
+	deque_mt_free(ctx.mt);
+	deque_free(locked.d);
+	pthread_mutex_destroy(&locked.lock);
+
+	return EXIT_SUCCESS;
+}
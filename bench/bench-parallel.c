@@ -0,0 +1,76 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-parallel.c deque_parallel_for_each, scaling with the threads */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-parallel.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* the xorshift rounds of work per item */
+static size_t work_per_item;
+
+static int expensive(struct deque *d, void *each, void *context)
+{
+	uint64_t x = (uintptr_t)each;
+	size_t i;
+
+	(void)d;
+	(void)context;
+	for (i = 0; i < work_per_item; ++i) {
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+	}
+	/* almost never non-zero, but the compiler can not know that */
+	return x == 0;
+}
+
+static void bench_parallel(struct deque *d, size_t nthreads)
+{
+	char variant[80];
+	uint64_t start;
+
+	start = bench_now_ns();
+	bench_sink += deque_parallel_for_each(d, expensive, NULL, nthreads);
+	sprintf(variant, "work-%lu/threads-%lu", (unsigned long)work_per_item,
+		(unsigned long)nthreads);
+	bench_report("parallel_for_each", variant, deque_size(d),
+		     deque_size(d), bench_now_ns() - start);
+}
+
+int main(int argc, char **argv)
+{
+	size_t n = bench_arg_size(argc, argv, 1, 4 * 1000 * 1000);
+	size_t max_threads = bench_arg_size(argc, argv, 2, 0);
+	struct deque *d = deque_new();
+	size_t i, t;
+
+	if (!max_threads) {
+		max_threads = (size_t)sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (!d) {
+		fprintf(stderr, "deque_new failed\n");
+		return EXIT_FAILURE;
+	}
+	for (i = 0; i < n; ++i) {
+		if (!deque_push(d, (void *)(uintptr_t)(i + 1))) {
+			fprintf(stderr, "out of memory\n");
+			return EXIT_FAILURE;
+		}
+	}
+
+	for (work_per_item = 1; work_per_item <= 1000; work_per_item *= 10) {
+		for (t = 1; t <= max_threads; t *= 2) {
+			bench_parallel(d, t);
+		}
+		if ((t / 2) != max_threads) {
+			bench_parallel(d, max_threads);
+		}
+	}
+
+	deque_free(d);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,300 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-patterns.c common workload patterns across deque sizes */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "eembed.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+   Each pattern is run against deques of 16 items up to the maximum
+   (by default 10^8), for at least min_ops operations, by repeating.
+   Allocations are counted by wrapping the allocator, and the bytes
+   copied by wrapping eembed_memmove and eembed_memcpy.
+*/
+
+static struct eembed_allocator *bench_real_allocator;
+static size_t bench_allocs;
+static uint64_t bench_bytes_copied;
+
+static void *(*bench_real_memmove)(void *dest, const void *src, size_t n);
+static void *(*bench_real_memcpy)(void *dest, const void *src, size_t n);
+
+static void *counting_memmove(void *dest, const void *src, size_t n)
+{
+	bench_bytes_copied += n;
+	return bench_real_memmove(dest, src, n);
+}
+
+static void *counting_memcpy(void *dest, const void *src, size_t n)
+{
+	bench_bytes_copied += n;
+	return bench_real_memcpy(dest, src, n);
+}
+
+static void *counting_malloc(struct eembed_allocator *ea, size_t size)
+{
+	(void)ea;
+	++bench_allocs;
+	return bench_real_allocator->malloc(bench_real_allocator, size);
+}
+
+static void *counting_calloc(struct eembed_allocator *ea, size_t nmemb,
+			     size_t size)
+{
+	(void)ea;
+	++bench_allocs;
+	return bench_real_allocator->calloc(bench_real_allocator, nmemb, size);
+}
+
+static void *counting_realloc(struct eembed_allocator *ea, void *ptr,
+			      size_t size)
+{
+	(void)ea;
+	++bench_allocs;
+	return bench_real_allocator->realloc(bench_real_allocator, ptr, size);
+}
+
+static void *counting_reallocarray(struct eembed_allocator *ea, void *ptr,
+				   size_t nmemb, size_t size)
+{
+	(void)ea;
+	++bench_allocs;
+	return bench_real_allocator->reallocarray(bench_real_allocator, ptr,
+						  nmemb, size);
+}
+
+static void counting_free(struct eembed_allocator *ea, void *ptr)
+{
+	(void)ea;
+	bench_real_allocator->free(bench_real_allocator, ptr);
+}
+
+#define bench_item(i) ((void *)(uintptr_t)((i) + 1))
+
+typedef size_t (*bench_pattern_func)(struct deque *d, size_t n,
+				     size_t rounds);
+
+/* returns the number of operations, or 0 if a push failed */
+static size_t pattern_stack(struct deque *d, size_t n, size_t rounds)
+{
+	uintptr_t sum = 0;
+	size_t r, i;
+
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			if (!deque_push(d, bench_item(i))) {
+				return 0;
+			}
+		}
+		for (i = 0; i < n; ++i) {
+			sum += (uintptr_t)deque_pop(d);
+		}
+	}
+	bench_sink += sum;
+	return 2 * n * rounds;
+}
+
+static size_t pattern_fifo(struct deque *d, size_t n, size_t rounds)
+{
+	uintptr_t sum = 0;
+	size_t r, i;
+
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			if (!deque_push(d, bench_item(i))) {
+				return 0;
+			}
+		}
+		for (i = 0; i < n; ++i) {
+			sum += (uintptr_t)deque_shift(d);
+		}
+	}
+	bench_sink += sum;
+	return 2 * n * rounds;
+}
+
+static size_t pattern_alternate(struct deque *d, size_t n, size_t rounds)
+{
+	uintptr_t sum = 0;
+	size_t r, i;
+
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			if (!((i & 1) ? deque_push(d, bench_item(i))
+			      : deque_unshift(d, bench_item(i)))) {
+				return 0;
+			}
+		}
+		for (i = 0; i < n; ++i) {
+			sum += (uintptr_t)((i & 1) ? deque_pop(d)
+					   : deque_shift(d));
+		}
+	}
+	bench_sink += sum;
+	return 2 * n * rounds;
+}
+
+/* the deque stays at n items, as a queue with a steady flow */
+static size_t pattern_window(struct deque *d, size_t n, size_t rounds)
+{
+	uintptr_t sum = 0;
+	size_t i;
+
+	for (i = 0; i < n * rounds; ++i) {
+		if (!deque_push(d, bench_item(i))) {
+			return 0;
+		}
+		sum += (uintptr_t)deque_shift(d);
+	}
+	bench_sink += sum;
+	return 2 * n * rounds;
+}
+
+/* as fifo, but with a shrink policy, thus grows and shrinks each round */
+static size_t pattern_burst(struct deque *d, size_t n, size_t rounds)
+{
+	struct deque_policy policy;
+	size_t ops;
+
+	eembed_memset(&policy, 0x00, sizeof(struct deque_policy));
+	policy.shrink_divisor = 4;
+	deque_set_policy(d, &policy);
+	ops = pattern_fifo(d, n, rounds);
+	deque_set_policy(d, NULL);
+	return ops;
+}
+
+static size_t pattern_peek(struct deque *d, size_t n, size_t rounds)
+{
+	uintptr_t sum = 0;
+	uint32_t x = 2463534242UL;
+	size_t i;
+
+	for (i = 0; i < n * rounds; ++i) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		sum += (uintptr_t)((i & 1) ? deque_peek_top(d, x % n)
+				   : deque_peek_bottom(d, x % n));
+	}
+	bench_sink += sum;
+	return n * rounds;
+}
+
+/* items which are there before the clock starts */
+static int prefill(struct deque *d, bench_pattern_func pattern, size_t n)
+{
+	size_t i;
+
+	if (pattern != pattern_window && pattern != pattern_peek) {
+		return 0;
+	}
+	for (i = 0; i < n; ++i) {
+		if (!((i & 1) ? deque_push(d, bench_item(i))
+		      : deque_unshift(d, bench_item(i)))) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void bench_pattern(const char *name, bench_pattern_func pattern,
+			  const char *variant, unsigned options,
+			  struct eembed_allocator *ea, size_t n,
+			  size_t min_ops)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 0, ea, options);
+	size_t rounds = (min_ops / (2 * n)) ? (min_ops / (2 * n)) : 1;
+	size_t allocs;
+	uint64_t copied, start, ns;
+	size_t ops;
+
+	if (!d || prefill(d, pattern, n)) {
+		fprintf(stderr, "%s %s %lu: out of memory\n", name, variant,
+			(unsigned long)n);
+		deque_free(d);
+		return;
+	}
+
+	allocs = bench_allocs;
+	copied = bench_bytes_copied;
+	start = bench_now_ns();
+	ops = pattern(d, n, rounds);
+	ns = bench_now_ns() - start;
+	if (!ops) {
+		fprintf(stderr, "%s %s %lu: out of memory\n", name, variant,
+			(unsigned long)n);
+	} else {
+		bench_report_counts(name, variant, n, ops, ns,
+				    bench_allocs - allocs,
+				    bench_bytes_copied - copied);
+	}
+
+	deque_free(d);
+}
+
+/* 16, 256, 4096, ... and the max_n itself; returns 0 after max_n */
+static size_t next_size(size_t n, size_t max_n)
+{
+	if (n >= max_n) {
+		return 0;
+	}
+	return (n * 16 > max_n) ? max_n : n * 16;
+}
+
+struct bench_pattern_entry {
+	const char *name;
+	bench_pattern_func pattern;
+};
+
+int main(int argc, char **argv)
+{
+	size_t max_n = bench_arg_size(argc, argv, 1, 100UL * 1000 * 1000);
+	size_t min_ops = bench_arg_size(argc, argv, 2, 10UL * 1000 * 1000);
+	struct bench_pattern_entry patterns[] = {
+		{ "stack", pattern_stack },
+		{ "fifo", pattern_fifo },
+		{ "alternate", pattern_alternate },
+		{ "window", pattern_window },
+		{ "burst-drain", pattern_burst },
+		{ "random-peek", pattern_peek },
+		{ NULL, NULL }
+	};
+	struct eembed_allocator counting;
+	size_t i, n;
+
+	bench_real_allocator = eembed_global_allocator;
+	counting = *bench_real_allocator;
+	counting.context = NULL;
+	counting.malloc = counting_malloc;
+	counting.calloc = counting_calloc;
+	counting.realloc =
+	    bench_real_allocator->realloc ? counting_realloc : NULL;
+	counting.reallocarray =
+	    bench_real_allocator->reallocarray ? counting_reallocarray : NULL;
+	counting.free = counting_free;
+
+	bench_real_memmove = eembed_memmove;
+	bench_real_memcpy = eembed_memcpy;
+	eembed_memmove = counting_memmove;
+	eembed_memcpy = counting_memcpy;
+
+	for (i = 0; patterns[i].name; ++i) {
+		for (n = 16; n && n <= max_n; n = next_size(n, max_n)) {
+			bench_pattern(patterns[i].name, patterns[i].pattern,
+				      "linear", 0, &counting, n, min_ops);
+			bench_pattern(patterns[i].name, patterns[i].pattern,
+				      "ring", Deque_option_ring, &counting, n,
+				      min_ops);
+		}
+	}
+
+	eembed_memmove = bench_real_memmove;
+	eembed_memcpy = bench_real_memcpy;
+
+	return EXIT_SUCCESS;
+}
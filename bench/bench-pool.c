@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-pool.c many short-lived deques, deque_new compared to a pool */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-pool.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* live is the number of deques in use at once, each with a few items */
+static void bench_pool(size_t live, size_t rounds)
+{
+	struct deque **d = NULL;
+	struct deque_pool *pool = NULL;
+	uintptr_t sum = 0;
+	uint64_t start;
+	size_t i, r;
+
+	d = (struct deque **)malloc(sizeof(struct deque *) * live);
+	pool = deque_pool_create(NULL, 0, 0);
+	if (!d || !pool) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < live; ++i) {
+			d[i] = deque_new();
+			deque_push(d[i], d);
+			deque_push(d[i], d);
+		}
+		for (i = 0; i < live; ++i) {
+			sum += (uintptr_t)deque_shift(d[i]);
+			deque_free(d[i]);
+		}
+	}
+	bench_report("new-free", "deque_new", live, live * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < live; ++i) {
+			d[i] = deque_pool_get(pool);
+			deque_push(d[i], d);
+			deque_push(d[i], d);
+		}
+		for (i = 0; i < live; ++i) {
+			sum += (uintptr_t)deque_shift(d[i]);
+			deque_pool_put(pool, d[i]);
+		}
+	}
+	bench_report("new-free", "deque_pool", live, live * rounds,
+		     bench_now_ns() - start);
+
+	deque_pool_destroy(pool);
+	free(d);
+	bench_sink += sum;
+}
+
+int main(int argc, char **argv)
+{
+	size_t max_live = bench_arg_size(argc, argv, 1, 64 * 1024);
+	size_t min_ops = bench_arg_size(argc, argv, 2, 4UL * 1000 * 1000);
+	size_t live, rounds;
+
+	for (live = 1; live <= max_live; live *= 16) {
+		rounds = (min_ops / live) ? (min_ops / live) : 1;
+		bench_pool(live, rounds);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-scrub.c init and drain of large deques, by scrub option */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static void bench_scrub(const char *variant, unsigned options, size_t n)
+{
+	struct deque *d = NULL;
+	struct deque caller;
+	void **buf = NULL;
+	uintptr_t sum = 0;
+	uint64_t start;
+	size_t i;
+
+	/* allocated by libdeque: only the first pages are touched */
+	start = bench_now_ns();
+	d = deque_init_options(NULL, NULL, n, NULL, options);
+	if (!d) {
+		fprintf(stderr, "deque_init_options failed\n");
+		exit(EXIT_FAILURE);
+	}
+	bench_report("init", variant, n, 1, bench_now_ns() - start);
+
+	for (i = 0; i < n; ++i) {
+		deque_push(d, (void *)(uintptr_t)(i + 1));
+	}
+	start = bench_now_ns();
+	for (i = 0; i < n; ++i) {
+		sum += (uintptr_t)((i & 1) ? deque_pop(d) : deque_shift(d));
+	}
+	bench_report("drain", variant, n, n, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	deque_free(d);
+	bench_report("free", variant, n, 1, bench_now_ns() - start);
+
+	/* a data_space passed in by the caller, and not yet touched */
+	buf = (void **)malloc(sizeof(void *) * n);
+	if (!buf) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	start = bench_now_ns();
+	deque_init_options(&caller, buf, n, NULL, options);
+	deque_push(&caller, &caller);
+	sum += (uintptr_t)deque_pop(&caller);
+	deque_free(&caller);
+	bench_report("caller-buffer-init-free", variant, n, 1,
+		     bench_now_ns() - start);
+	free(buf);
+
+	bench_sink += sum;
+}
+
+int main(int argc, char **argv)
+{
+	size_t max_n = bench_arg_size(argc, argv, 1, 64UL * 1024 * 1024);
+	size_t n;
+
+	for (n = 1024 * 1024; n <= max_n; n *= 8) {
+		bench_scrub("default", 0, n);
+		bench_scrub("no_scrub", Deque_option_no_scrub, n);
+		bench_scrub("secure_scrub", Deque_option_secure_scrub, n);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-seg.c very large deques: contiguous compared to segmented */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "deque-seg.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define bench_item(i) ((void *)(uintptr_t)((i) + 1))
+
+/* pushes are timed in chunks, to find the stall of the biggest grow */
+#define Bench_chunk 1024
+
+static void bench_fill_report(const char *variant, size_t total, size_t i,
+			      uint64_t ns, uint64_t max_ns)
+{
+	bench_report("fill", variant, total, i, ns);
+	bench_report("fill-slowest-chunk", variant, total, Bench_chunk,
+		     max_ns);
+}
+
+static void bench_deque(const char *variant, unsigned options, size_t total)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 0, NULL, options);
+	uint64_t start, before, each, max_ns = 0;
+	uintptr_t sum = 0;
+	uint32_t x = 2463534242UL;
+	size_t i;
+
+	if (!d) {
+		fprintf(stderr, "deque_init_options failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = bench_now_ns();
+	before = start;
+	for (i = 0; i < total; ++i) {
+		if (!deque_push(d, bench_item(i))) {
+			fprintf(stderr, "%s: push %lu failed\n", variant,
+				(unsigned long)i);
+			break;
+		}
+		if ((i % Bench_chunk) == (Bench_chunk - 1)) {
+			each = bench_now_ns() - before;
+			max_ns = (each > max_ns) ? each : max_ns;
+			before += each;
+		}
+	}
+	bench_fill_report(variant, total, i, bench_now_ns() - start, max_ns);
+
+	start = bench_now_ns();
+	for (i = 0; i < total && deque_size(d); ++i) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		sum += (uintptr_t)deque_peek_bottom(d, x % deque_size(d));
+	}
+	bench_report("random-peek", variant, total, i, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (i = 0; deque_size(d); ++i) {
+		sum += (uintptr_t)deque_shift(d);
+	}
+	bench_report("drain", variant, total, i, bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_free(d);
+}
+
+static void bench_seg(const char *variant, size_t block_len, size_t total)
+{
+	struct deque_seg *d = deque_seg_init(NULL, block_len, NULL);
+	uint64_t start, before, each, max_ns = 0;
+	uintptr_t sum = 0;
+	uint32_t x = 2463534242UL;
+	size_t i;
+
+	if (!d) {
+		fprintf(stderr, "deque_seg_init failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = bench_now_ns();
+	before = start;
+	for (i = 0; i < total; ++i) {
+		if (!deque_seg_push(d, bench_item(i))) {
+			fprintf(stderr, "%s: push %lu failed\n", variant,
+				(unsigned long)i);
+			break;
+		}
+		if ((i % Bench_chunk) == (Bench_chunk - 1)) {
+			each = bench_now_ns() - before;
+			max_ns = (each > max_ns) ? each : max_ns;
+			before += each;
+		}
+	}
+	bench_fill_report(variant, total, i, bench_now_ns() - start, max_ns);
+
+	start = bench_now_ns();
+	for (i = 0; i < total && deque_seg_size(d); ++i) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		sum += (uintptr_t)deque_seg_peek_bottom(d,
+							x % deque_seg_size(d));
+	}
+	bench_report("random-peek", variant, total, i, bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (i = 0; deque_seg_size(d); ++i) {
+		sum += (uintptr_t)deque_seg_shift(d);
+	}
+	bench_report("drain", variant, total, i, bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_seg_free(d);
+}
+
+int main(int argc, char **argv)
+{
+	size_t total = bench_arg_size(argc, argv, 1, 100UL * 1000 * 1000);
+
+	bench_deque("deque", 0, total);
+	bench_deque("deque-ring", Deque_option_ring, total);
+	bench_seg("deque_seg-64", 64, total);
+	bench_seg("deque_seg-512", 512, total);
+	bench_seg("deque_seg-4096", 4096, total);
+
+	return EXIT_SUCCESS;
+}
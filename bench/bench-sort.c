@@ -0,0 +1,106 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-sort.c deque_sort compared to a round-trip through qsort */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int by_value(void *a, void *b, void *context)
+{
+	uintptr_t x = (uintptr_t)a;
+	uintptr_t y = (uintptr_t)b;
+
+	(void)context;
+	return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+static int qsort_by_value(const void *a, const void *b)
+{
+	return by_value(*(void *const *)a, *(void *const *)b, NULL);
+}
+
+static void fill_random(struct deque *d, size_t n, uint32_t *x)
+{
+	size_t i;
+
+	deque_clear(d);
+	for (i = 0; i < n; ++i) {
+		*x ^= *x << 13;
+		*x ^= *x >> 17;
+		*x ^= *x << 5;
+		if (!deque_push(d, (void *)(uintptr_t)(1 + *x))) {
+			fprintf(stderr, "out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+static void bench_sort(size_t n, size_t rounds)
+{
+	struct deque *d = deque_new();
+	void **tmp = (void **)malloc(sizeof(void *) * n);
+	uint32_t x = 2463534242UL;
+	uint64_t start, elapsed;
+	size_t r, got;
+
+	if (!d || !tmp) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* without deque_sort: copy out, sort, copy back */
+	elapsed = 0;
+	for (r = 0; r < rounds; ++r) {
+		fill_random(d, n, &x);
+		start = bench_now_ns();
+		got = deque_shift_n(d, tmp, n);
+		qsort(tmp, got, sizeof(void *), qsort_by_value);
+		deque_push_n(d, tmp, got);
+		elapsed += bench_now_ns() - start;
+	}
+	bench_report("sort", "round-trip-qsort", n, n * rounds, elapsed);
+
+	elapsed = 0;
+	for (r = 0; r < rounds; ++r) {
+		fill_random(d, n, &x);
+		start = bench_now_ns();
+		deque_sort(d, by_value, NULL);
+		elapsed += bench_now_ns() - start;
+	}
+	bench_report("sort", "deque_sort", n, n * rounds, elapsed);
+	bench_sink += (uintptr_t)deque_peek_bottom(d, 0);
+
+	/* building a sorted deque one item at a time */
+	elapsed = 0;
+	for (r = 0; r < rounds; ++r) {
+		fill_random(d, n, &x);
+		got = deque_shift_n(d, tmp, n);
+		start = bench_now_ns();
+		while (got) {
+			deque_insert_sorted(d, tmp[--got], by_value, NULL);
+		}
+		elapsed += bench_now_ns() - start;
+	}
+	bench_report("insert_sorted", "deque", n, n * rounds, elapsed);
+	bench_sink += (uintptr_t)deque_peek_bottom(d, 0);
+
+	free(tmp);
+	deque_free(d);
+}
+
+int main(int argc, char **argv)
+{
+	size_t max_n = bench_arg_size(argc, argv, 1, 64 * 1024);
+	size_t min_ops = bench_arg_size(argc, argv, 2, 2UL * 1000 * 1000);
+	size_t n, rounds;
+
+	for (n = 16; n <= max_n; n *= 16) {
+		rounds = (min_ops / n) ? (min_ops / n) : 1;
+		bench_sort(n, rounds);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-spsc.c handoff between two threads: throughput and latency */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-spsc.h"
+#include "deque-mt.h"
+#include "bench.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define Bench_ring_bytes 4096
+
+struct handoff {
+	struct deque_spsc *to;
+	struct deque_spsc *from;
+	struct deque_mt *mt;
+	size_t total;
+};
+
+static void *spsc_producer(void *arg)
+{
+	struct handoff *h = (struct handoff *)arg;
+	size_t i;
+
+	for (i = 1; i <= h->total; ++i) {
+		while (!deque_spsc_push(h->to, (void *)(uintptr_t)i)) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void *mt_producer(void *arg)
+{
+	struct handoff *h = (struct handoff *)arg;
+	size_t i;
+
+	for (i = 1; i <= h->total; ++i) {
+		deque_mt_push(h->mt, (void *)(uintptr_t)i);
+	}
+	return NULL;
+}
+
+/* returns each item back, for round trip latency */
+static void *spsc_echo(void *arg)
+{
+	struct handoff *h = (struct handoff *)arg;
+	size_t i;
+	void *data;
+
+	for (i = 0; i < h->total; ++i) {
+		while ((data = deque_spsc_shift(h->to)) == NULL) {
+			sched_yield();
+		}
+		while (!deque_spsc_push(h->from, data)) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void bench_throughput(struct handoff *h)
+{
+	pthread_t thread;
+	uint64_t start;
+	size_t i;
+
+	start = bench_now_ns();
+	pthread_create(&thread, NULL, spsc_producer, h);
+	for (i = 0; i < h->total; ++i) {
+		while (!deque_spsc_shift(h->to)) {
+			sched_yield();
+		}
+	}
+	pthread_join(thread, NULL);
+	bench_report("spsc-throughput", "deque_spsc", h->total, h->total,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	pthread_create(&thread, NULL, mt_producer, h);
+	for (i = 0; i < h->total; ++i) {
+		while (!deque_mt_shift(h->mt)) {
+			sched_yield();
+		}
+	}
+	pthread_join(thread, NULL);
+	bench_report("spsc-throughput", "deque_mt", h->total, h->total,
+		     bench_now_ns() - start);
+}
+
+static void bench_latency(struct handoff *h)
+{
+	pthread_t thread;
+	uint64_t start;
+	size_t i;
+
+	start = bench_now_ns();
+	pthread_create(&thread, NULL, spsc_echo, h);
+	for (i = 1; i <= h->total; ++i) {
+		while (!deque_spsc_push(h->to, (void *)(uintptr_t)i)) {
+			sched_yield();
+		}
+		while (!deque_spsc_shift(h->from)) {
+			sched_yield();
+		}
+	}
+	pthread_join(thread, NULL);
+	/* ns_per_op is the round trip */
+	bench_report("spsc-round-trip", "deque_spsc", h->total, h->total,
+		     bench_now_ns() - start);
+}
+
+int main(int argc, char **argv)
+{
+	size_t total = bench_arg_size(argc, argv, 1, 10 * 1000 * 1000);
+	size_t round_trips = bench_arg_size(argc, argv, 2, 100 * 1000);
+	static unsigned char to_bytes[Bench_ring_bytes];
+	static unsigned char from_bytes[Bench_ring_bytes];
+	struct handoff h;
+
+	h.to = deque_spsc_new_no_allocator(to_bytes, sizeof(to_bytes));
+	h.from = deque_spsc_new_no_allocator(from_bytes, sizeof(from_bytes));
+	h.mt = deque_mt_new();
+	if (!h.to || !h.from || !h.mt) {
+		fprintf(stderr, "init failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	h.total = total;
+	bench_throughput(&h);
+
+	h.total = round_trips;
+	bench_latency(&h);
+
+	deque_mt_free(h.mt);
+
+	return EXIT_SUCCESS;
+}
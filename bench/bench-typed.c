@@ -0,0 +1,133 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-typed.c the header-only typed deque compared to the library */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "deque-typed.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+Deque_define(deque_uptr, uintptr_t);
+
+static void bench_library(size_t n, size_t rounds)
+{
+	struct deque *d = deque_new();
+	uintptr_t sum = 0;
+	uint64_t start;
+	size_t r, i;
+
+	if (!d) {
+		fprintf(stderr, "deque_new failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			deque_push(d, (void *)(uintptr_t)(i + 1));
+		}
+		for (i = 0; i < n; ++i) {
+			sum += (uintptr_t)deque_pop(d);
+		}
+	}
+	bench_report("stack", "library", n, 2 * n * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			deque_push(d, (void *)(uintptr_t)(i + 1));
+		}
+		for (i = 0; i < n; ++i) {
+			sum += (uintptr_t)deque_shift(d);
+		}
+	}
+	bench_report("fifo", "library", n, 2 * n * rounds,
+		     bench_now_ns() - start);
+
+	for (i = 0; i < n; ++i) {
+		deque_unshift(d, (void *)(uintptr_t)(i + 1));
+	}
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			sum += (uintptr_t)deque_peek_bottom(d, i);
+		}
+	}
+	bench_report("peek-scan", "library", n, n * rounds,
+		     bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_free(d);
+}
+
+static void bench_typed(size_t n, size_t rounds)
+{
+	struct deque_uptr *d = deque_uptr_new(NULL);
+	uintptr_t sum = 0, out = 0;
+	uint64_t start;
+	size_t r, i;
+
+	if (!d) {
+		fprintf(stderr, "deque_uptr_new failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			deque_uptr_push(d, i + 1);
+		}
+		for (i = 0; i < n; ++i) {
+			deque_uptr_pop(d, &out);
+			sum += out;
+		}
+	}
+	bench_report("stack", "typed", n, 2 * n * rounds,
+		     bench_now_ns() - start);
+
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			deque_uptr_push(d, i + 1);
+		}
+		for (i = 0; i < n; ++i) {
+			deque_uptr_shift(d, &out);
+			sum += out;
+		}
+	}
+	bench_report("fifo", "typed", n, 2 * n * rounds,
+		     bench_now_ns() - start);
+
+	for (i = 0; i < n; ++i) {
+		deque_uptr_unshift(d, i + 1);
+	}
+	start = bench_now_ns();
+	for (r = 0; r < rounds; ++r) {
+		for (i = 0; i < n; ++i) {
+			sum += *deque_uptr_peek_bottom(d, i);
+		}
+	}
+	bench_report("peek-scan", "typed", n, n * rounds,
+		     bench_now_ns() - start);
+
+	bench_sink += sum;
+	deque_uptr_free(d);
+}
+
+int main(int argc, char **argv)
+{
+	size_t max_n = bench_arg_size(argc, argv, 1, 1000 * 1000);
+	size_t min_ops = bench_arg_size(argc, argv, 2, 20UL * 1000 * 1000);
+	size_t n, rounds;
+
+	for (n = 16; n <= max_n; n *= 16) {
+		rounds = (min_ops / (2 * n)) ? (min_ops / (2 * n)) : 1;
+		bench_library(n, rounds);
+		bench_typed(n, rounds);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench-ws.c work-stealing tree traversal, compared to a shared deque */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "deque-ws.h"
+#include "eembed.h"
+#include "bench.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+   Each task is a node of an implicit binary tree, identified by its
+   depth. Nodes above the cutoff split into two tasks, nodes at the
+   cutoff walk their subtree sequentially, thus the work is uneven in
+   time and must be balanced between the workers.
+*/
+#define Bench_cutoff 12
+
+struct pool {
+	size_t workers;
+	struct deque_ws **deques;
+	/* or, all workers share one deque behind one lock */
+	pthread_mutex_t lock;
+	struct deque *shared;
+	size_t outstanding;	/* updated with __atomic */
+	size_t leaves;		/* updated with __atomic */
+};
+
+struct worker {
+	struct pool *pool;
+	size_t id;
+	uint32_t rand;
+};
+
+/* a little work at each leaf, which can not be folded away */
+static uint32_t walk(size_t depth, uint32_t x)
+{
+	if (!depth) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		return x;
+	}
+	return walk(depth - 1, (2 * x) + 1) ^ walk(depth - 1, 2 * x);
+}
+
+#define task_depth(task) (((size_t)(uintptr_t)(task)) - 1)
+#define depth_task(depth) ((void *)(uintptr_t)((depth) + 1))
+
+/* returns the number of new tasks */
+static size_t run_task(struct pool *pool, void *task, void **children)
+{
+	size_t depth = task_depth(task);
+
+	if (depth > Bench_cutoff) {
+		children[0] = depth_task(depth - 1);
+		children[1] = depth_task(depth - 1);
+		/* net one more task outstanding */
+		__atomic_fetch_add(&pool->outstanding, 1, __ATOMIC_RELAXED);
+		return 2;
+	}
+	__atomic_fetch_xor(&bench_sink,
+			   (uintptr_t)walk(depth, (uint32_t)depth),
+			   __ATOMIC_RELAXED);
+	__atomic_fetch_add(&pool->leaves, ((size_t)1) << depth,
+			   __ATOMIC_RELAXED);
+	__atomic_fetch_sub(&pool->outstanding, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+static void *ws_worker(void *arg)
+{
+	struct worker *w = (struct worker *)arg;
+	struct pool *pool = w->pool;
+	struct deque_ws *own = pool->deques[w->id];
+	void *children[2];
+	void *task;
+	size_t n;
+
+	while (__atomic_load_n(&pool->outstanding, __ATOMIC_ACQUIRE)) {
+		task = deque_ws_pop(own);
+		if (!task) {
+			/* xorshift, to pick a victim */
+			w->rand ^= w->rand << 13;
+			w->rand ^= w->rand >> 17;
+			w->rand ^= w->rand << 5;
+			task = deque_ws_shift(pool->deques[w->rand %
+							   pool->workers]);
+		}
+		if (!task) {
+			continue;
+		}
+		n = run_task(pool, task, children);
+		while (n) {
+			deque_ws_push(own, children[--n]);
+		}
+	}
+	return NULL;
+}
+
+static void *shared_worker(void *arg)
+{
+	struct worker *w = (struct worker *)arg;
+	struct pool *pool = w->pool;
+	void *children[2];
+	void *task;
+	size_t n;
+
+	while (__atomic_load_n(&pool->outstanding, __ATOMIC_ACQUIRE)) {
+		pthread_mutex_lock(&pool->lock);
+		task = deque_pop(pool->shared);
+		pthread_mutex_unlock(&pool->lock);
+		if (!task) {
+			continue;
+		}
+		n = run_task(pool, task, children);
+		pthread_mutex_lock(&pool->lock);
+		while (n) {
+			deque_push(pool->shared, children[--n]);
+		}
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return NULL;
+}
+
+static void bench_tree(const char *variant, size_t workers, size_t depth,
+		       void *(*work)(void *))
+{
+	struct pool pool;
+	struct worker *w = NULL;
+	pthread_t *threads = NULL;
+	char mode[40];
+	uint64_t start;
+	size_t i;
+
+	eembed_memset(&pool, 0x00, sizeof(struct pool));
+	pool.workers = workers;
+	pool.deques = (struct deque_ws **)calloc(workers, sizeof(void *));
+	w = (struct worker *)calloc(workers, sizeof(struct worker));
+	threads = (pthread_t *)calloc(workers, sizeof(pthread_t));
+	pool.shared = deque_new();
+	if (!pool.deques || !w || !threads || !pool.shared) {
+		fprintf(stderr, "calloc failed\n");
+		exit(EXIT_FAILURE);
+	}
+	pthread_mutex_init(&pool.lock, NULL);
+	for (i = 0; i < workers; ++i) {
+		pool.deques[i] = deque_ws_new();
+		if (!pool.deques[i]) {
+			fprintf(stderr, "deque_ws_new failed\n");
+			exit(EXIT_FAILURE);
+		}
+		w[i].pool = &pool;
+		w[i].id = i;
+		w[i].rand = 2463534242UL + i;
+	}
+
+	/* the root */
+	pool.outstanding = 1;
+	if (work == ws_worker) {
+		deque_ws_push(pool.deques[0], depth_task(depth));
+	} else {
+		deque_push(pool.shared, depth_task(depth));
+	}
+
+	start = bench_now_ns();
+	for (i = 0; i < workers; ++i) {
+		pthread_create(&threads[i], NULL, work, &w[i]);
+	}
+	for (i = 0; i < workers; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+	sprintf(mode, "tree-%lu-threads", (unsigned long)workers);
+	bench_report(mode, variant, ((size_t)1) << depth, pool.leaves,
+		     bench_now_ns() - start);
+
+	for (i = 0; i < workers; ++i) {
+		deque_ws_free(pool.deques[i]);
+	}
+	deque_free(pool.shared);
+	pthread_mutex_destroy(&pool.lock);
+	free(threads);
+	free(w);
+	free(pool.deques);
+}
+
+int main(int argc, char **argv)
+{
+	size_t depth = bench_arg_size(argc, argv, 1, 28);
+	size_t max_workers = bench_arg_size(argc, argv, 2, 8);
+	size_t workers;
+
+	for (workers = 1; workers <= max_workers; workers *= 2) {
+		bench_tree("deque_ws", workers, depth, ws_worker);
+		bench_tree("mutex-deque", workers, depth, shared_worker);
+	}
+
+	return EXIT_SUCCESS;
+}
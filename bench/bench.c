@@ -0,0 +1,211 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench.c common helpers for the libdeque benchmarks */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+volatile uintptr_t bench_sink;
+
+uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (((uint64_t)ts.tv_sec) * 1000000000UL) + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t bench_cpu_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return (((uint64_t)ts.tv_sec) * 1000000000UL) + (uint64_t)ts.tv_nsec;
+}
+
+size_t bench_arg_size(int argc, char **argv, int i, size_t default_val)
+{
+	if (argc > i) {
+		return (size_t)strtoull(argv[i], NULL, 10);
+	}
+	return default_val;
+}
+
+void bench_report(const char *bench, const char *variant, size_t items,
+		  size_t ops, uint64_t ns)
+{
+	double ns_per_op = ops ? ((double)ns / (double)ops) : 0.0;
+
+	printf("{\"bench\": \"%s\", \"variant\": \"%s\", \"items\": %lu,"
+	       " \"ops\": %lu, \"ns\": %llu, \"ns_per_op\": %.3f}\n",
+	       bench, variant, (unsigned long)items, (unsigned long)ops,
+	       (unsigned long long)ns, ns_per_op);
+	fflush(stdout);
+}
+
+void bench_report_counts(const char *bench, const char *variant,
+			 size_t items, size_t ops, uint64_t ns,
+			 size_t allocs, uint64_t bytes_copied)
+{
+	double ns_per_op = ops ? ((double)ns / (double)ops) : 0.0;
+
+	printf("{\"bench\": \"%s\", \"variant\": \"%s\", \"items\": %lu,"
+	       " \"ops\": %lu, \"ns\": %llu, \"ns_per_op\": %.3f,"
+	       " \"allocs\": %lu, \"bytes_copied\": %llu}\n",
+	       bench, variant, (unsigned long)items, (unsigned long)ops,
+	       (unsigned long long)ns, ns_per_op, (unsigned long)allocs,
+	       (unsigned long long)bytes_copied);
+	fflush(stdout);
+}
+
+static const char *bench_perf_names[bench_perf_counters] = {
+	"cycles",
+	"instructions",
+	"l1d_misses",
+	"llc_misses",
+	"dtlb_misses",
+	"page_faults"
+};
+
+#ifdef __linux__
+static int bench_perf_open_one(uint32_t type, uint64_t config)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0x00, sizeof(struct perf_event_attr));
+	attr.size = sizeof(struct perf_event_attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	/* this thread, any cpu */
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+#define bench_perf_cache(cache, result) \
+	((PERF_COUNT_HW_CACHE_ ## cache) \
+	 | (PERF_COUNT_HW_CACHE_OP_READ << 8) \
+	 | (PERF_COUNT_HW_CACHE_RESULT_ ## result << 16))
+#endif
+
+int bench_perf_open(struct bench_perf *perf)
+{
+	int i, opened = 0;
+
+	for (i = 0; i < bench_perf_counters; ++i) {
+		perf->fd[i] = -1;
+		perf->count[i] = 0;
+	}
+#ifdef __linux__
+	perf->fd[bench_perf_cycles] =
+	    bench_perf_open_one(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	perf->fd[bench_perf_instructions] =
+	    bench_perf_open_one(PERF_TYPE_HARDWARE,
+				PERF_COUNT_HW_INSTRUCTIONS);
+	perf->fd[bench_perf_l1d_misses] =
+	    bench_perf_open_one(PERF_TYPE_HW_CACHE,
+				bench_perf_cache(L1D, MISS));
+	perf->fd[bench_perf_llc_misses] =
+	    bench_perf_open_one(PERF_TYPE_HARDWARE,
+				PERF_COUNT_HW_CACHE_MISSES);
+	perf->fd[bench_perf_dtlb_misses] =
+	    bench_perf_open_one(PERF_TYPE_HW_CACHE,
+				bench_perf_cache(DTLB, MISS));
+	perf->fd[bench_perf_page_faults] =
+	    bench_perf_open_one(PERF_TYPE_SOFTWARE,
+				PERF_COUNT_SW_PAGE_FAULTS);
+#endif
+	for (i = 0; i < bench_perf_counters; ++i) {
+		opened += (perf->fd[i] >= 0);
+	}
+	return opened;
+}
+
+void bench_perf_start(struct bench_perf *perf)
+{
+#ifdef __linux__
+	int i;
+
+	for (i = 0; i < bench_perf_counters; ++i) {
+		if (perf->fd[i] >= 0) {
+			ioctl(perf->fd[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(perf->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#else
+	(void)perf;
+#endif
+}
+
+void bench_perf_stop(struct bench_perf *perf)
+{
+#ifdef __linux__
+	uint64_t count;
+	int i;
+
+	for (i = 0; i < bench_perf_counters; ++i) {
+		if (perf->fd[i] >= 0) {
+			ioctl(perf->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+			count = 0;
+			if (read(perf->fd[i], &count, sizeof(uint64_t))
+			    != (ssize_t)sizeof(uint64_t)) {
+				count = 0;
+			}
+			perf->count[i] = count;
+		}
+	}
+#else
+	(void)perf;
+#endif
+}
+
+void bench_perf_close(struct bench_perf *perf)
+{
+	int i;
+
+	for (i = 0; i < bench_perf_counters; ++i) {
+#ifdef __linux__
+		if (perf->fd[i] >= 0) {
+			close(perf->fd[i]);
+		}
+#endif
+		perf->fd[i] = -1;
+	}
+}
+
+void bench_report_perf(const char *bench, const char *variant,
+		       size_t items, size_t ops, uint64_t ns,
+		       struct bench_perf *perf)
+{
+	double ns_per_op = ops ? ((double)ns / (double)ops) : 0.0;
+	double per_op;
+	int i;
+
+	printf("{\"bench\": \"%s\", \"variant\": \"%s\", \"items\": %lu,"
+	       " \"ops\": %lu, \"ns\": %llu, \"ns_per_op\": %.3f",
+	       bench, variant, (unsigned long)items, (unsigned long)ops,
+	       (unsigned long long)ns, ns_per_op);
+	for (i = 0; i < bench_perf_counters; ++i) {
+		if (perf->fd[i] >= 0) {
+			per_op = ops ? ((double)perf->count[i] / (double)ops)
+			    : 0.0;
+			printf(", \"%s_per_op\": %.4f", bench_perf_names[i],
+			       per_op);
+		}
+	}
+	printf("}\n");
+	fflush(stdout);
+}
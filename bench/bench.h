@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* bench.h common helpers for the libdeque benchmarks */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* each benchmark adds what it read or removed here, thus the compiler
+   can not discard the work */
+extern volatile uintptr_t bench_sink;
+
+/* monotonic clock, in nanoseconds */
+uint64_t bench_now_ns(void);
+
+/* cpu time used by all threads of the process, in nanoseconds */
+uint64_t bench_cpu_ns(void);
+
+/* parse argv[i] as a count, or return the default */
+size_t bench_arg_size(int argc, char **argv, int i, size_t default_val);
+
+/* print one result as a line of JSON on stdout */
+void bench_report(const char *bench, const char *variant, size_t items,
+		  size_t ops, uint64_t ns);
+
+/* as above, with the number of allocations and bytes copied */
+void bench_report_counts(const char *bench, const char *variant,
+			 size_t items, size_t ops, uint64_t ns,
+			 size_t allocs, uint64_t bytes_copied);
+
+/*
+   Hardware and software event counts for the calling thread, from
+   perf_event_open, on Linux. Each counter which can not be opened, as
+   in a VM without a PMU, or with perf_event_paranoid too high, is
+   simply left out of the report.
+*/
+enum bench_perf_counter {
+	bench_perf_cycles,
+	bench_perf_instructions,
+	bench_perf_l1d_misses,
+	bench_perf_llc_misses,
+	bench_perf_dtlb_misses,
+	bench_perf_page_faults,
+	bench_perf_counters
+};
+
+struct bench_perf {
+	int fd[bench_perf_counters];
+	uint64_t count[bench_perf_counters];
+};
+
+/* opens the counters, returns the number which could be opened */
+int bench_perf_open(struct bench_perf *perf);
+
+void bench_perf_start(struct bench_perf *perf);
+
+void bench_perf_stop(struct bench_perf *perf);
+
+void bench_perf_close(struct bench_perf *perf);
+
+/* as bench_report, with the counts per op from the last start/stop */
+void bench_report_perf(const char *bench, const char *variant,
+		       size_t items, size_t ops, uint64_t ns,
+		       struct bench_perf *perf);
+
+#endif /* BENCH_H */
@@ -0,0 +1,373 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-find.c searching a Double-Ended QUEue for a pointer value */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+
+/*
+   The items are compared over the (at most two) spans of slots, see
+   deque_as_spans. Deque_find_simd selects how:
+	2: AVX2 if the CPU supports it, as checked at runtime, else SSE2
+	1: SSE2, which every x86_64 CPU has
+	0: one item at a time, portable
+   The default is 2 on x86_64 with GCC or Clang; elsewhere, always 0.
+   The vector compares are of 64 bit lanes, thus not for the x32 ABI,
+   where a pointer is 32 bits.
+*/
+#if defined(__x86_64__) && defined(__GNUC__) && defined(__LP64__)
+#define Deque_find_x86_64 1
+#else
+#define Deque_find_x86_64 0
+#endif
+
+#ifndef Deque_find_simd
+#if Deque_find_x86_64
+#define Deque_find_simd 2
+#else
+#define Deque_find_simd 0
+#endif
+#endif
+
+#if Deque_find_simd && !Deque_find_x86_64
+#undef Deque_find_simd
+#define Deque_find_simd 0
+#endif
+
+/* over the n slots of one span */
+typedef size_t (*deque_span_func)(void **a, size_t n, const void *item);
+
+struct deque_find_funcs {
+	/* the index within the span, or n if not found */
+	deque_span_func first;
+	deque_span_func last;
+	/* the number found */
+	deque_span_func count;
+};
+
+#if Deque_find_simd
+#include <immintrin.h>
+
+/* SSE2 lacks a 64 bit compare: both 32 bit halves must be equal */
+static __m128i deque_cmpeq_sse2(const void *p, __m128i key)
+{
+	__m128i v = _mm_loadu_si128((const __m128i *)p);
+	__m128i eq = _mm_cmpeq_epi32(v, key);
+	__m128i swapped = _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1));
+
+	return _mm_and_si128(eq, swapped);
+}
+
+/* one bit per slot, for the 8 slots starting at p */
+static unsigned deque_mask8_sse2(void **p, __m128i key)
+{
+	unsigned m0, m1, m2, m3;
+
+	m0 = _mm_movemask_pd(_mm_castsi128_pd(deque_cmpeq_sse2(p, key)));
+	m1 = _mm_movemask_pd(_mm_castsi128_pd(deque_cmpeq_sse2(p + 2, key)));
+	m2 = _mm_movemask_pd(_mm_castsi128_pd(deque_cmpeq_sse2(p + 4, key)));
+	m3 = _mm_movemask_pd(_mm_castsi128_pd(deque_cmpeq_sse2(p + 6, key)));
+	return m0 | (m1 << 2) | (m2 << 4) | (m3 << 6);
+}
+
+static size_t deque_find_first_sse2(void **a, size_t n, const void *item)
+{
+	__m128i key = _mm_set1_epi64x((long long)(uintptr_t)item);
+	unsigned mask;
+	size_t i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		mask = deque_mask8_sse2(a + i, key);
+		if (mask) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	for (; i < n; ++i) {
+		if (a[i] == item) {
+			return i;
+		}
+	}
+	return n;
+}
+
+static size_t deque_find_last_sse2(void **a, size_t n, const void *item)
+{
+	__m128i key = _mm_set1_epi64x((long long)(uintptr_t)item);
+	unsigned mask;
+	size_t i;
+
+	for (i = n; i >= 8; i -= 8) {
+		mask = deque_mask8_sse2(a + i - 8, key);
+		if (mask) {
+			return i - 8 + (31 - __builtin_clz(mask));
+		}
+	}
+	for (; i > 0; --i) {
+		if (a[i - 1] == item) {
+			return i - 1;
+		}
+	}
+	return n;
+}
+
+static size_t deque_count_sse2(void **a, size_t n, const void *item)
+{
+	__m128i key = _mm_set1_epi64x((long long)(uintptr_t)item);
+	__m128i sum = _mm_setzero_si128();
+	long long lanes[2];
+	size_t i, found;
+
+	/* a match is -1 in its lane, thus subtract to count */
+	for (i = 0; i + 2 <= n; i += 2) {
+		sum = _mm_sub_epi64(sum, deque_cmpeq_sse2(a + i, key));
+	}
+	_mm_storeu_si128((__m128i *)lanes, sum);
+	found = (size_t)(lanes[0] + lanes[1]);
+	if (i < n) {
+		found += (a[i] == item);
+	}
+	return found;
+}
+
+static const struct deque_find_funcs deque_find_sse2 = {
+	deque_find_first_sse2,
+	deque_find_last_sse2,
+	deque_count_sse2
+};
+
+#if Deque_find_simd > 1
+#define Deque_avx2 __attribute__((target("avx2")))
+
+/* one bit per slot, for the 16 slots starting at p */
+Deque_avx2 static unsigned deque_mask16_avx2(void **p, __m256i key)
+{
+	__m256i c0, c1, c2, c3;
+	unsigned m0, m1, m2, m3;
+
+	c0 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)p), key);
+	c1 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(p + 4)),
+				key);
+	c2 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(p + 8)),
+				key);
+	c3 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(p + 12)),
+				key);
+	if (_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(c0, c1),
+					       _mm256_or_si256(c2, c3)),
+			       _mm256_set1_epi64x(-1))) {
+		return 0;
+	}
+	m0 = _mm256_movemask_pd(_mm256_castsi256_pd(c0));
+	m1 = _mm256_movemask_pd(_mm256_castsi256_pd(c1));
+	m2 = _mm256_movemask_pd(_mm256_castsi256_pd(c2));
+	m3 = _mm256_movemask_pd(_mm256_castsi256_pd(c3));
+	return m0 | (m1 << 4) | (m2 << 8) | (m3 << 12);
+}
+
+Deque_avx2 static size_t deque_find_first_avx2(void **a, size_t n,
+					       const void *item)
+{
+	__m256i key = _mm256_set1_epi64x((long long)(uintptr_t)item);
+	unsigned mask;
+	size_t i;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		mask = deque_mask16_avx2(a + i, key);
+		if (mask) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	for (; i < n; ++i) {
+		if (a[i] == item) {
+			return i;
+		}
+	}
+	return n;
+}
+
+Deque_avx2 static size_t deque_find_last_avx2(void **a, size_t n,
+					      const void *item)
+{
+	__m256i key = _mm256_set1_epi64x((long long)(uintptr_t)item);
+	unsigned mask;
+	size_t i;
+
+	for (i = n; i >= 16; i -= 16) {
+		mask = deque_mask16_avx2(a + i - 16, key);
+		if (mask) {
+			return i - 16 + (31 - __builtin_clz(mask));
+		}
+	}
+	for (; i > 0; --i) {
+		if (a[i - 1] == item) {
+			return i - 1;
+		}
+	}
+	return n;
+}
+
+Deque_avx2 static size_t deque_count_avx2(void **a, size_t n,
+					  const void *item)
+{
+	__m256i key = _mm256_set1_epi64x((long long)(uintptr_t)item);
+	__m256i sum0 = _mm256_setzero_si256();
+	__m256i sum1 = _mm256_setzero_si256();
+	__m256i v0, v1;
+	long long lanes[4];
+	size_t i, found;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		v0 = _mm256_loadu_si256((const __m256i *)(a + i));
+		v1 = _mm256_loadu_si256((const __m256i *)(a + i + 4));
+		sum0 = _mm256_sub_epi64(sum0, _mm256_cmpeq_epi64(v0, key));
+		sum1 = _mm256_sub_epi64(sum1, _mm256_cmpeq_epi64(v1, key));
+	}
+	_mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi64(sum0, sum1));
+	found = (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+	for (; i < n; ++i) {
+		found += (a[i] == item);
+	}
+	return found;
+}
+
+static const struct deque_find_funcs deque_find_avx2 = {
+	deque_find_first_avx2,
+	deque_find_last_avx2,
+	deque_count_avx2
+};
+
+#endif /* Deque_find_simd > 1 */
+
+#if Deque_find_simd > 1
+/* checked on the first call; a race only makes the same choice twice */
+static const struct deque_find_funcs *deque_find_selected = NULL;
+
+static const struct deque_find_funcs *deque_find_select(void)
+{
+	const struct deque_find_funcs *f = NULL;
+
+	f = __atomic_load_n(&deque_find_selected, __ATOMIC_RELAXED);
+	if (f) {
+		return f;
+	}
+	__builtin_cpu_init();
+	f = __builtin_cpu_supports("avx2") ? &deque_find_avx2
+	    : &deque_find_sse2;
+	__atomic_store_n(&deque_find_selected, f, __ATOMIC_RELAXED);
+	return f;
+}
+#else
+static const struct deque_find_funcs *deque_find_select(void)
+{
+	return &deque_find_sse2;
+}
+#endif
+#else
+static size_t deque_find_first_scalar(void **a, size_t n, const void *item)
+{
+	size_t i;
+
+	for (i = 0; i < n; ++i) {
+		if (a[i] == item) {
+			return i;
+		}
+	}
+	return n;
+}
+
+static size_t deque_find_last_scalar(void **a, size_t n, const void *item)
+{
+	size_t i;
+
+	for (i = n; i > 0; --i) {
+		if (a[i - 1] == item) {
+			return i - 1;
+		}
+	}
+	return n;
+}
+
+static size_t deque_count_scalar(void **a, size_t n, const void *item)
+{
+	size_t i, found = 0;
+
+	for (i = 0; i < n; ++i) {
+		found += (a[i] == item);
+	}
+	return found;
+}
+
+static const struct deque_find_funcs deque_find_scalar = {
+	deque_find_first_scalar,
+	deque_find_last_scalar,
+	deque_count_scalar
+};
+
+static const struct deque_find_funcs *deque_find_select(void)
+{
+	return &deque_find_scalar;
+}
+#endif /* Deque_find_simd */
+
+size_t deque_find(struct deque *d, const void *item)
+{
+	const struct deque_find_funcs *f = deque_find_select();
+	void **a, **b;
+	size_t a_len, b_len, i;
+
+	deque_as_spans(d, &a, &a_len, &b, &b_len);
+	if (a_len) {
+		i = f->first(a, a_len, item);
+		if (i < a_len) {
+			return i;
+		}
+	}
+	if (b_len) {
+		i = f->first(b, b_len, item);
+		if (i < b_len) {
+			return a_len + i;
+		}
+	}
+	return Deque_not_found;
+}
+
+size_t deque_find_last(struct deque *d, const void *item)
+{
+	const struct deque_find_funcs *f = deque_find_select();
+	void **a, **b;
+	size_t a_len, b_len, i;
+
+	deque_as_spans(d, &a, &a_len, &b, &b_len);
+	if (b_len) {
+		i = f->last(b, b_len, item);
+		if (i < b_len) {
+			return a_len + i;
+		}
+	}
+	if (a_len) {
+		i = f->last(a, a_len, item);
+		if (i < a_len) {
+			return i;
+		}
+	}
+	return Deque_not_found;
+}
+
+int deque_contains(struct deque *d, const void *item)
+{
+	return deque_find(d, item) != Deque_not_found;
+}
+
+size_t deque_count(struct deque *d, const void *item)
+{
+	const struct deque_find_funcs *f = deque_find_select();
+	void **a, **b;
+	size_t a_len, b_len, found = 0;
+
+	deque_as_spans(d, &a, &a_len, &b, &b_len);
+	if (a_len) {
+		found += f->count(a, a_len, item);
+	}
+	if (b_len) {
+		found += f->count(b, b_len, item);
+	}
+	return found;
+}
@@ -0,0 +1,326 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-inline.c Double-Ended QUEue of fixed size elements, by value */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+/*
+   The data_space is always a ring: the element at index i from the
+   bottom is in slot (first_pos + i), wrapped around data_space_len.
+   When full, the data_space doubles, and the ring is unwrapped.
+*/
+#include "deque-inline.h"
+#include "eembed.h"
+
+#define deque_inline_assert(d) do { \
+	eembed_assert(d != NULL); \
+	eembed_assert(d->data_space != NULL); \
+	eembed_assert(d->ea != NULL); \
+	eembed_assert(d->elem_size > 0); \
+	eembed_assert(d->size <= d->data_space_len); \
+	eembed_assert(d->first_pos < d->data_space_len); \
+} while (0)
+
+/* the address of the element at index i from the bottom */
+static unsigned char *deque_inline_at(struct deque_inline *d, size_t i)
+{
+	size_t pos = d->first_pos + i;
+
+	if (pos >= d->data_space_len) {
+		pos -= d->data_space_len;
+	}
+	return d->data_space + (pos * d->elem_size);
+}
+
+static struct deque_inline *deque_inline_grow(struct deque_inline *d)
+{
+	struct eembed_allocator *ea = d->ea;
+	size_t old_len = d->data_space_len;
+	size_t new_len = old_len * 2;
+	size_t max_len = ((size_t)-1) / d->elem_size;
+	size_t tail = old_len - d->first_pos;
+	unsigned char *new_space = NULL;
+
+	if (new_len < old_len || new_len > max_len) {
+		return NULL;
+	}
+
+	if (ea->realloc && d->data_space_needs_free) {
+		new_space = (unsigned char *)ea->realloc(ea, d->data_space,
+							 new_len *
+							 d->elem_size);
+		if (!new_space) {
+			return NULL;
+		}
+		if (d->size > tail) {
+			/* the wrapped elements follow on, after the old end */
+			eembed_memcpy(new_space + (old_len * d->elem_size),
+				      new_space,
+				      (d->size - tail) * d->elem_size);
+		}
+	} else {
+		new_space = (unsigned char *)ea->malloc(ea,
+							new_len * d->elem_size);
+		if (!new_space) {
+			return NULL;
+		}
+		if (tail > d->size) {
+			tail = d->size;
+		}
+		eembed_memcpy(new_space, deque_inline_at(d, 0),
+			      tail * d->elem_size);
+		eembed_memcpy(new_space + (tail * d->elem_size), d->data_space,
+			      (d->size - tail) * d->elem_size);
+		if (d->data_space_needs_free) {
+			ea->free(ea, d->data_space);
+		}
+		d->first_pos = 0;
+		d->data_space_needs_free = 1;
+	}
+	d->data_space = new_space;
+	d->data_space_len = new_len;
+
+	return d;
+}
+
+struct deque_inline *deque_inline_push(struct deque_inline *d,
+				       const void *elem)
+{
+	deque_inline_assert(d);
+
+	if (d->size == d->data_space_len && !deque_inline_grow(d)) {
+		return NULL;
+	}
+	eembed_memcpy(deque_inline_at(d, d->size), elem, d->elem_size);
+	++d->size;
+
+	return d;
+}
+
+struct deque_inline *deque_inline_pop(struct deque_inline *d, void *out)
+{
+	deque_inline_assert(d);
+
+	if (!d->size) {
+		return NULL;
+	}
+	--d->size;
+	if (out) {
+		eembed_memcpy(out, deque_inline_at(d, d->size), d->elem_size);
+	}
+
+	return d;
+}
+
+struct deque_inline *deque_inline_unshift(struct deque_inline *d,
+					  const void *elem)
+{
+	deque_inline_assert(d);
+
+	if (d->size == d->data_space_len && !deque_inline_grow(d)) {
+		return NULL;
+	}
+	if (!d->first_pos) {
+		d->first_pos = d->data_space_len;
+	}
+	--d->first_pos;
+	eembed_memcpy(d->data_space + (d->first_pos * d->elem_size), elem,
+		      d->elem_size);
+	++d->size;
+
+	return d;
+}
+
+struct deque_inline *deque_inline_shift(struct deque_inline *d, void *out)
+{
+	deque_inline_assert(d);
+
+	if (!d->size) {
+		return NULL;
+	}
+	if (out) {
+		eembed_memcpy(out, deque_inline_at(d, 0), d->elem_size);
+	}
+	--d->size;
+	++d->first_pos;
+	if (d->first_pos == d->data_space_len) {
+		d->first_pos = 0;
+	}
+
+	return d;
+}
+
+void *deque_inline_peek_top(struct deque_inline *d, size_t index)
+{
+	deque_inline_assert(d);
+
+	if (index >= d->size) {
+		return NULL;
+	}
+
+	return deque_inline_at(d, d->size - (index + 1));
+}
+
+void *deque_inline_peek_bottom(struct deque_inline *d, size_t index)
+{
+	deque_inline_assert(d);
+
+	if (index >= d->size) {
+		return NULL;
+	}
+
+	return deque_inline_at(d, index);
+}
+
+size_t deque_inline_size(struct deque_inline *d)
+{
+	deque_inline_assert(d);
+
+	return d->size;
+}
+
+size_t deque_inline_capacity(struct deque_inline *d)
+{
+	deque_inline_assert(d);
+
+	return d->data_space_len;
+}
+
+void deque_inline_clear(struct deque_inline *d)
+{
+	deque_inline_assert(d);
+
+	d->first_pos = 0;
+	d->size = 0;
+}
+
+int deque_inline_for_each(struct deque_inline *d,
+			  deque_inline_iterator_func func, void *context)
+{
+	unsigned char *each = NULL;
+	unsigned char *end_of_space = NULL;
+	size_t i, end;
+
+	deque_inline_assert(d);
+
+	end_of_space = d->data_space + (d->data_space_len * d->elem_size);
+	each = deque_inline_at(d, 0);
+	end = 0;
+	for (i = 0; i < d->size && !end; ++i) {
+		end = func(d, each, context);
+		each += d->elem_size;
+		if (each == end_of_space) {
+			each = d->data_space;
+		}
+	}
+	return end;
+}
+
+struct deque_inline *deque_inline_init(struct deque_inline *d,
+				       size_t elem_size,
+				       size_t data_space_len,
+				       struct eembed_allocator *ea)
+{
+	if (!elem_size) {
+		return NULL;
+	}
+
+	if (!ea) {
+		ea = eembed_global_allocator;
+	}
+
+	if (!data_space_len) {
+		data_space_len = Deque_default_len;
+	}
+	if (data_space_len > ((size_t)-1) / elem_size) {
+		return NULL;
+	}
+
+	if (d) {
+		eembed_memset(d, 0x00, sizeof(struct deque_inline));
+	} else {
+		d = (struct deque_inline *)ea->calloc(ea, 1,
+						      sizeof(struct
+							     deque_inline));
+		if (!d) {
+			return NULL;
+		}
+		d->deque_needs_free = 1;
+	}
+
+	d->data_space = (unsigned char *)ea->malloc(ea,
+						    data_space_len * elem_size);
+	if (!d->data_space) {
+		if (d->deque_needs_free) {
+			ea->free(ea, d);
+		}
+		return NULL;
+	}
+	d->data_space_needs_free = 1;
+	d->data_space_len = data_space_len;
+	d->elem_size = elem_size;
+	d->ea = ea;
+
+	deque_inline_assert(d);
+
+	return d;
+}
+
+struct deque_inline *deque_inline_new(size_t elem_size)
+{
+	return deque_inline_init(NULL, elem_size, 0, NULL);
+}
+
+struct deque_inline *deque_inline_new_custom_allocator(size_t elem_size,
+						       struct eembed_allocator
+						       *ea)
+{
+	return deque_inline_init(NULL, elem_size, 0, ea);
+}
+
+struct deque_inline *deque_inline_new_no_allocator(size_t elem_size,
+						   unsigned char *bytes,
+						   size_t bytes_len)
+{
+	struct deque_inline *d = NULL;
+	size_t used = eembed_align(sizeof(struct deque_inline));
+
+	if (!bytes || !elem_size || bytes_len < (used + elem_size)) {
+		return NULL;
+	}
+
+	eembed_memset(bytes, 0x00, bytes_len);
+	d = (struct deque_inline *)bytes;
+	d->data_space = bytes + used;
+	d->data_space_len = (bytes_len - used) / elem_size;
+	d->elem_size = elem_size;
+	d->ea = eembed_null_allocator;
+
+	deque_inline_assert(d);
+
+	return d;
+}
+
+void deque_inline_free(struct deque_inline *d)
+{
+	struct eembed_allocator *ea = NULL;
+
+	if (!d) {
+		return;
+	}
+
+	eembed_assert(d->ea);
+
+	ea = d->ea;
+
+	if (d->data_space_needs_free) {
+		ea->free(ea, d->data_space);
+		d->data_space = NULL;
+		d->data_space_len = 0;
+		d->data_space_needs_free = 0;
+	}
+	d->first_pos = 0;
+	d->size = 0;
+
+	if (d->deque_needs_free) {
+		ea->free(ea, d);
+	}
+}
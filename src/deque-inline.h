@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-inline.h Double-Ended QUEue of fixed size elements, by value */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef DEQUE_INLINE_H
+#define DEQUE_INLINE_H
+
+#include "deque.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   Rather than a (void *) per item, each element of elem_size bytes is
+   copied in to, and out of, the data_space, which is used as a ring.
+   Small structs can thus be queued without an allocation per item, and
+   iteration streams through contiguous memory.
+*/
+struct deque_inline {
+	/* the index of the first element, always less than data_space_len */
+	size_t first_pos;
+	size_t size;
+	size_t elem_size;
+	/* in elements, not bytes */
+	size_t data_space_len;
+	unsigned char *data_space;
+	struct eembed_allocator *ea;
+	unsigned deque_needs_free:1;
+	unsigned data_space_needs_free:1;
+};
+
+typedef int (*deque_inline_iterator_func)(struct deque_inline *d, void *each,
+					  void *context);
+
+/* a data_space_len of zero uses Deque_default_len */
+struct deque_inline *deque_inline_init(struct deque_inline *d,
+				       size_t elem_size,
+				       size_t data_space_len,
+				       struct eembed_allocator *ea);
+
+struct deque_inline *deque_inline_new(size_t elem_size);
+struct deque_inline *deque_inline_new_custom_allocator(size_t elem_size,
+						       struct eembed_allocator
+						       *ea);
+/* a bounded deque within the bytes, which never allocates */
+struct deque_inline *deque_inline_new_no_allocator(size_t elem_size,
+						   unsigned char *bytes,
+						   size_t bytes_len);
+
+void deque_inline_free(struct deque_inline *d);
+
+/* copy elem_size bytes from elem to the end of queue (or top of stack) */
+struct deque_inline *deque_inline_push(struct deque_inline *d,
+				       const void *elem);
+
+/* copy the element at the end of the queue (or top of stack) to out,
+   if out is not NULL, and remove it; returns NULL if it was empty */
+struct deque_inline *deque_inline_pop(struct deque_inline *d, void *out);
+
+/* copy elem_size bytes from elem to the front of queue */
+struct deque_inline *deque_inline_unshift(struct deque_inline *d,
+					  const void *elem);
+
+/* copy the element at the front of queue to out, if out is not NULL,
+   and remove it; returns NULL if it was empty */
+struct deque_inline *deque_inline_shift(struct deque_inline *d, void *out);
+
+/* pointers to the element within the data_space, which are valid until
+   the next push, pop, shift, or unshift; NULL if out of range */
+void *deque_inline_peek_top(struct deque_inline *d, size_t index);
+void *deque_inline_peek_bottom(struct deque_inline *d, size_t index);
+
+/* return the number of elements in the deque */
+size_t deque_inline_size(struct deque_inline *d);
+
+/* return the number of elements which fit before growing */
+size_t deque_inline_capacity(struct deque_inline *d);
+
+/* reset the deque to an empty state */
+void deque_inline_clear(struct deque_inline *d);
+
+/* internal iterator, "each" points to the element in the data_space */
+int deque_inline_for_each(struct deque_inline *d,
+			  deque_inline_iterator_func func, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEQUE_INLINE_H */
@@ -0,0 +1,290 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-mmap.c an mmap backed allocator for large data_space buffers */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+/*
+   Every allocation is preceded by a header, which records the length of
+   the mapping (zero if it is from the small allocator), the size which
+   was asked for, and the page size by which the mapping is rounded. As
+   the header is four size_t, memory from a mapping is aligned to at
+   least 4 * sizeof(size_t); memory from the small allocator is aligned
+   only as well as that allocator aligns, e.g. 16 bytes for glibc malloc
+   on x86_64.
+*/
+
+/* for mremap, before any system header */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "deque-mmap.h"
+#include "eembed.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#define Deque_mmap_huge_page (2UL * 1024 * 1024)
+
+struct deque_mmap_header {
+	size_t mapped;
+	size_t size;
+	size_t granule;
+	size_t reserved;
+};
+
+#define Deque_mmap_header_len sizeof(struct deque_mmap_header)
+
+#define deque_mmap_header(ptr) \
+	((struct deque_mmap_header *) \
+	 (((unsigned char *)(ptr)) - Deque_mmap_header_len))
+
+#define deque_mmap_data(h) \
+	((void *)(((unsigned char *)(h)) + Deque_mmap_header_len))
+
+/* the bytes needed for size, rounded up to a multiple of granule */
+static size_t deque_mmap_len(size_t size, size_t granule)
+{
+	size_t len = size + Deque_mmap_header_len;
+
+	if (len < size) {
+		return 0;
+	}
+	len = (len + (granule - 1)) & ~(granule - 1);
+	return (len < size) ? 0 : len;
+}
+
+static struct deque_mmap_header *deque_mmap_map(struct deque_mmap_allocator *a,
+						size_t size)
+{
+	struct deque_mmap_header *h = NULL;
+	void *p = MAP_FAILED;
+	size_t granule = a->page_size;
+	size_t len = 0;
+
+#ifdef MAP_HUGETLB
+	if (a->options & Deque_mmap_hugetlb) {
+		len = deque_mmap_len(size, a->huge_page_size);
+		if (len) {
+			p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+				 -1, 0);
+			granule = a->huge_page_size;
+		}
+	}
+#endif
+	if (p == MAP_FAILED) {
+		granule = a->page_size;
+		len = deque_mmap_len(size, granule);
+		if (!len) {
+			return NULL;
+		}
+		p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED) {
+			return NULL;
+		}
+#ifdef MADV_HUGEPAGE
+		if (a->options & Deque_mmap_thp) {
+			/* only advice, thus a failure is not an error */
+			madvise(p, len, MADV_HUGEPAGE);
+		}
+#endif
+	}
+
+	h = (struct deque_mmap_header *)p;
+	h->mapped = len;
+	h->size = size;
+	h->granule = granule;
+	return h;
+}
+
+static void *deque_mmap_malloc(struct eembed_allocator *ea, size_t size)
+{
+	struct deque_mmap_allocator *a =
+	    (struct deque_mmap_allocator *)ea->context;
+	struct deque_mmap_header *h = NULL;
+
+	if (size >= a->min_bytes) {
+		h = deque_mmap_map(a, size);
+		return h ? deque_mmap_data(h) : NULL;
+	}
+	h = (struct deque_mmap_header *)
+	    a->small->malloc(a->small, Deque_mmap_header_len + size);
+	if (!h) {
+		return NULL;
+	}
+	h->mapped = 0;
+	h->size = size;
+	h->granule = 0;
+	return deque_mmap_data(h);
+}
+
+static void *deque_mmap_calloc(struct eembed_allocator *ea, size_t nmemb,
+			       size_t size)
+{
+	struct deque_mmap_allocator *a =
+	    (struct deque_mmap_allocator *)ea->context;
+	struct deque_mmap_header *h = NULL;
+	size_t total = nmemb * size;
+
+	if (size && (total / size) != nmemb) {
+		return NULL;
+	}
+	if (total >= a->min_bytes) {
+		/* a new anonymous mapping is already zeroed */
+		h = deque_mmap_map(a, total);
+		return h ? deque_mmap_data(h) : NULL;
+	}
+	h = (struct deque_mmap_header *)
+	    a->small->calloc(a->small, 1, Deque_mmap_header_len + total);
+	if (!h) {
+		return NULL;
+	}
+	h->mapped = 0;
+	h->size = total;
+	h->granule = 0;
+	return deque_mmap_data(h);
+}
+
+static void deque_mmap_free(struct eembed_allocator *ea, void *ptr)
+{
+	struct deque_mmap_allocator *a =
+	    (struct deque_mmap_allocator *)ea->context;
+	struct deque_mmap_header *h = NULL;
+
+	if (!ptr) {
+		return;
+	}
+	h = deque_mmap_header(ptr);
+	if (h->mapped) {
+		munmap(h, h->mapped);
+	} else {
+		a->small->free(a->small, h);
+	}
+}
+
+/* move from the small allocator to a mapping */
+static void *deque_mmap_from_small(struct deque_mmap_allocator *a,
+				   struct deque_mmap_header *old, size_t size)
+{
+	struct deque_mmap_header *h = deque_mmap_map(a, size);
+
+	if (!h) {
+		return NULL;
+	}
+	eembed_memcpy(deque_mmap_data(h), deque_mmap_data(old),
+		      (old->size < size) ? old->size : size);
+	a->small->free(a->small, old);
+	return deque_mmap_data(h);
+}
+
+static void *deque_mmap_realloc(struct eembed_allocator *ea, void *ptr,
+				size_t size)
+{
+	struct deque_mmap_allocator *a =
+	    (struct deque_mmap_allocator *)ea->context;
+	struct deque_mmap_header *h = NULL;
+	struct deque_mmap_header *moved = NULL;
+	void *p = MAP_FAILED;
+	size_t old_len, len;
+
+	if (!ptr) {
+		return deque_mmap_malloc(ea, size);
+	}
+	h = deque_mmap_header(ptr);
+
+	if (!h->mapped) {
+		if (size >= a->min_bytes) {
+			return deque_mmap_from_small(a, h, size);
+		}
+		len = Deque_mmap_header_len + size;
+		h = (struct deque_mmap_header *)a->small->realloc(a->small, h,
+								   len);
+		if (!h) {
+			return NULL;
+		}
+		h->size = size;
+		return deque_mmap_data(h);
+	}
+
+	len = deque_mmap_len(size, h->granule);
+	if (!len) {
+		return NULL;
+	}
+	if (len <= h->mapped) {
+		/* within the mapping: give back the pages no longer used,
+		   but keep the address range for growing again */
+		old_len = deque_mmap_len(h->size, h->granule);
+		if (len < old_len) {
+			madvise(((unsigned char *)h) + len, old_len - len,
+				MADV_DONTNEED);
+		}
+		h->size = size;
+		return ptr;
+	}
+
+#ifdef MREMAP_MAYMOVE
+	/* the kernel moves the page table entries, not the bytes */
+	p = mremap(h, h->mapped, len, MREMAP_MAYMOVE);
+#endif
+	if (p != MAP_FAILED) {
+		h = (struct deque_mmap_header *)p;
+		h->mapped = len;
+		h->size = size;
+		return deque_mmap_data(h);
+	}
+
+	moved = deque_mmap_map(a, size);
+	if (!moved) {
+		return NULL;
+	}
+	eembed_memcpy(deque_mmap_data(moved), ptr, h->size);
+	munmap(h, h->mapped);
+	return deque_mmap_data(moved);
+}
+
+static void *deque_mmap_reallocarray(struct eembed_allocator *ea, void *ptr,
+				     size_t nmemb, size_t size)
+{
+	size_t total = nmemb * size;
+
+	if (size && (total / size) != nmemb) {
+		return NULL;
+	}
+	return deque_mmap_realloc(ea, ptr, total);
+}
+
+struct eembed_allocator *deque_mmap_allocator_init(struct
+						   deque_mmap_allocator *a,
+						   struct eembed_allocator
+						   *small, size_t min_bytes,
+						   unsigned options)
+{
+	long page_size = sysconf(_SC_PAGESIZE);
+
+	eembed_memset(a, 0x00, sizeof(struct deque_mmap_allocator));
+	a->small = small ? small : eembed_global_allocator;
+	a->min_bytes = min_bytes ? min_bytes : Deque_mmap_min_bytes;
+	a->page_size = (page_size > 0) ? (size_t)page_size : 4096;
+	a->huge_page_size = Deque_mmap_huge_page;
+	a->options = options;
+
+	a->ea.context = a;
+	a->ea.malloc = deque_mmap_malloc;
+	a->ea.calloc = deque_mmap_calloc;
+	a->ea.realloc = deque_mmap_realloc;
+	a->ea.reallocarray = deque_mmap_reallocarray;
+	a->ea.free = deque_mmap_free;
+
+	return &a->ea;
+}
+
+int deque_mmap_is_mapped(struct eembed_allocator *ea, void *ptr)
+{
+	(void)ea;
+	return (ptr && deque_mmap_header(ptr)->mapped) ? 1 : 0;
+}
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-mmap.h an mmap backed allocator for large data_space buffers */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef DEQUE_MMAP_H
+#define DEQUE_MMAP_H
+
+#include "deque.h"
+#include "eembed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   An eembed_allocator for very large deques, thus it may simply be
+   passed to deque_new_custom_allocator or deque_init_options.
+
+   Allocations of at least min_bytes are each given their own mapping,
+   which grows with mremap (thus without copying the items), and which
+   is not unmapped when shrunk, rather the pages past the new end are
+   returned with madvise(MADV_DONTNEED), so that growing again within
+   the mapping is free. Smaller allocations, such as the struct deque
+   itself, are passed to the "small" allocator.
+*/
+
+/* allocations of fewer bytes use the small allocator */
+#ifndef Deque_mmap_min_bytes
+#define Deque_mmap_min_bytes (256 * 1024)
+#endif
+
+/* ask for transparent huge pages, with madvise(MADV_HUGEPAGE) */
+#define Deque_mmap_thp (1U << 0)
+
+/* try MAP_HUGETLB first, which needs huge pages reserved by the admin;
+   if that fails, a mapping of normal pages is used */
+#define Deque_mmap_hugetlb (1U << 1)
+
+struct deque_mmap_allocator {
+	/* first, thus a (struct eembed_allocator *) may be cast */
+	struct eembed_allocator ea;
+	struct eembed_allocator *small;
+	size_t min_bytes;
+	size_t page_size;
+	size_t huge_page_size;
+	unsigned options;
+};
+
+/* a NULL small uses eembed_global_allocator, a min_bytes of zero uses
+   Deque_mmap_min_bytes; returns &a->ea */
+struct eembed_allocator *deque_mmap_allocator_init(struct
+						   deque_mmap_allocator *a,
+						   struct eembed_allocator
+						   *small, size_t min_bytes,
+						   unsigned options);
+
+/* non-zero if the allocation was mapped rather than from small */
+int deque_mmap_is_mapped(struct eembed_allocator *ea, void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEQUE_MMAP_H */
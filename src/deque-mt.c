@@ -0,0 +1,516 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-mt.c thread-safe Double-Ended QUEue */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+/*
+   The data_space length is a power of two, and the positions are free
+   running: they are never reset, and the slot is (pos & mask). Each
+   end writes only its own position, and reads the other with acquire.
+
+   An end may work alone only while there are more than Deque_mt_margin
+   items and more than Deque_mt_margin free slots, as measured with the
+   last published position of the other end. The other end can move by
+   at most one slot before publishing, thus the two ends can never touch
+   the same slot, and can never overfill the data_space.
+
+   Empty and full are only ever decided while holding both locks. A
+   waiter counts itself before trying, thus any thread which changes
+   the deque after that try will, after releasing its lock, see the
+   waiter in the count, and signal it.
+*/
+#include "deque-mt.h"
+#include "eembed.h"
+
+#include <errno.h>
+#include <time.h>
+
+#define Deque_mt_margin 2
+
+/* the timed waits use CLOCK_MONOTONIC where the condition variable can
+   be set to it, as configure checks; else the default, CLOCK_REALTIME */
+#ifndef Deque_mt_monotonic
+#define Deque_mt_monotonic 0
+#endif
+
+#if Deque_mt_monotonic
+#define Deque_mt_clock CLOCK_MONOTONIC
+#else
+#define Deque_mt_clock CLOCK_REALTIME
+#endif
+
+#define deque_mt_load(pos) __atomic_load_n(&(pos), __ATOMIC_ACQUIRE)
+#define deque_mt_store(pos, val) \
+	__atomic_store_n(&(pos), (val), __ATOMIC_RELEASE)
+
+#define deque_mt_bottom(d) (&(d)->bottom.end)
+#define deque_mt_top(d) (&(d)->top.end)
+#define deque_mt_len(d) ((d)->mask + 1)
+
+/* the number of items at which an add must take both locks */
+#define deque_mt_limit(d) \
+	(((d)->max_size && (d)->max_size < deque_mt_len(d)) \
+		? (d)->max_size : deque_mt_len(d))
+
+enum deque_mt_op {
+	deque_mt_op_push,
+	deque_mt_op_pop,
+	deque_mt_op_unshift,
+	deque_mt_op_shift
+};
+
+static void deque_mt_lock_both(struct deque_mt *d)
+{
+	pthread_mutex_lock(&deque_mt_bottom(d)->lock);
+	pthread_mutex_lock(&deque_mt_top(d)->lock);
+}
+
+static void deque_mt_unlock_both(struct deque_mt *d)
+{
+	pthread_mutex_unlock(&deque_mt_top(d)->lock);
+	pthread_mutex_unlock(&deque_mt_bottom(d)->lock);
+}
+
+/* both locks must be held */
+static size_t deque_mt_used(struct deque_mt *d)
+{
+	return deque_mt_top(d)->pos - deque_mt_bottom(d)->pos;
+}
+
+/* both locks must be held: double the data_space */
+static struct deque_mt *deque_mt_grow(struct deque_mt *d)
+{
+	struct eembed_allocator *ea = d->ea;
+	size_t first = deque_mt_bottom(d)->pos;
+	size_t end = deque_mt_top(d)->pos;
+	size_t new_len = deque_mt_len(d) * 2;
+	size_t new_mask = new_len - 1;
+	void **new_space = NULL;
+	size_t pos;
+
+	if (new_len < deque_mt_len(d)) {
+		return NULL;
+	}
+	new_space = (void **)ea->calloc(ea, new_len, sizeof(void *));
+	if (!new_space) {
+		return NULL;
+	}
+	for (pos = first; pos != end; ++pos) {
+		new_space[pos & new_mask] = d->data_space[pos & d->mask];
+	}
+	ea->free(ea, d->data_space);
+	d->data_space = new_space;
+	d->mask = new_mask;
+	return d;
+}
+
+/* both locks must be held */
+static int deque_mt_make_room(struct deque_mt *d)
+{
+	size_t used = deque_mt_used(d);
+
+	if (d->max_size && used >= d->max_size) {
+		return EAGAIN;
+	}
+	if (used == deque_mt_len(d) && !deque_mt_grow(d)) {
+		return ENOMEM;
+	}
+	return 0;
+}
+
+static int deque_mt_push_locked(struct deque_mt *d, void *data)
+{
+	struct deque_mt_end *top = deque_mt_top(d);
+	int rv;
+
+	deque_mt_lock_both(d);
+	rv = deque_mt_make_room(d);
+	if (!rv) {
+		d->data_space[top->pos & d->mask] = data;
+		deque_mt_store(top->pos, top->pos + 1);
+	}
+	deque_mt_unlock_both(d);
+	return rv;
+}
+
+static int deque_mt_try_push(struct deque_mt *d, void *data)
+{
+	struct deque_mt_end *top = deque_mt_top(d);
+	size_t first, end;
+
+	pthread_mutex_lock(&top->lock);
+	end = top->pos;
+	first = deque_mt_load(deque_mt_bottom(d)->pos);
+	if ((end - first) + Deque_mt_margin >= deque_mt_limit(d)) {
+		pthread_mutex_unlock(&top->lock);
+		return deque_mt_push_locked(d, data);
+	}
+	d->data_space[end & d->mask] = data;
+	deque_mt_store(top->pos, end + 1);
+	pthread_mutex_unlock(&top->lock);
+	return 0;
+}
+
+static int deque_mt_pop_locked(struct deque_mt *d, void **out)
+{
+	struct deque_mt_end *top = deque_mt_top(d);
+	int rv = EAGAIN;
+	size_t slot;
+
+	deque_mt_lock_both(d);
+	if (deque_mt_used(d)) {
+		slot = (top->pos - 1) & d->mask;
+		*out = d->data_space[slot];
+		d->data_space[slot] = NULL;
+		deque_mt_store(top->pos, top->pos - 1);
+		rv = 0;
+	}
+	deque_mt_unlock_both(d);
+	return rv;
+}
+
+static int deque_mt_try_pop(struct deque_mt *d, void **out)
+{
+	struct deque_mt_end *top = deque_mt_top(d);
+	size_t first, end;
+
+	pthread_mutex_lock(&top->lock);
+	end = top->pos;
+	first = deque_mt_load(deque_mt_bottom(d)->pos);
+	if ((end - first) <= Deque_mt_margin) {
+		pthread_mutex_unlock(&top->lock);
+		return deque_mt_pop_locked(d, out);
+	}
+	--end;
+	*out = d->data_space[end & d->mask];
+	d->data_space[end & d->mask] = NULL;
+	deque_mt_store(top->pos, end);
+	pthread_mutex_unlock(&top->lock);
+	return 0;
+}
+
+static int deque_mt_unshift_locked(struct deque_mt *d, void *data)
+{
+	struct deque_mt_end *bottom = deque_mt_bottom(d);
+	int rv;
+
+	deque_mt_lock_both(d);
+	rv = deque_mt_make_room(d);
+	if (!rv) {
+		d->data_space[(bottom->pos - 1) & d->mask] = data;
+		deque_mt_store(bottom->pos, bottom->pos - 1);
+	}
+	deque_mt_unlock_both(d);
+	return rv;
+}
+
+static int deque_mt_try_unshift(struct deque_mt *d, void *data)
+{
+	struct deque_mt_end *bottom = deque_mt_bottom(d);
+	size_t first, end;
+
+	pthread_mutex_lock(&bottom->lock);
+	first = bottom->pos;
+	end = deque_mt_load(deque_mt_top(d)->pos);
+	if ((end - first) + Deque_mt_margin >= deque_mt_limit(d)) {
+		pthread_mutex_unlock(&bottom->lock);
+		return deque_mt_unshift_locked(d, data);
+	}
+	--first;
+	d->data_space[first & d->mask] = data;
+	deque_mt_store(bottom->pos, first);
+	pthread_mutex_unlock(&bottom->lock);
+	return 0;
+}
+
+static int deque_mt_shift_locked(struct deque_mt *d, void **out)
+{
+	struct deque_mt_end *bottom = deque_mt_bottom(d);
+	int rv = EAGAIN;
+	size_t slot;
+
+	deque_mt_lock_both(d);
+	if (deque_mt_used(d)) {
+		slot = bottom->pos & d->mask;
+		*out = d->data_space[slot];
+		d->data_space[slot] = NULL;
+		deque_mt_store(bottom->pos, bottom->pos + 1);
+		rv = 0;
+	}
+	deque_mt_unlock_both(d);
+	return rv;
+}
+
+static int deque_mt_try_shift(struct deque_mt *d, void **out)
+{
+	struct deque_mt_end *bottom = deque_mt_bottom(d);
+	size_t first, end;
+
+	pthread_mutex_lock(&bottom->lock);
+	first = bottom->pos;
+	end = deque_mt_load(deque_mt_top(d)->pos);
+	if ((end - first) <= Deque_mt_margin) {
+		pthread_mutex_unlock(&bottom->lock);
+		return deque_mt_shift_locked(d, out);
+	}
+	*out = d->data_space[first & d->mask];
+	d->data_space[first & d->mask] = NULL;
+	deque_mt_store(bottom->pos, first + 1);
+	pthread_mutex_unlock(&bottom->lock);
+	return 0;
+}
+
+/* returns 0, or EAGAIN if empty (or full), or ENOMEM */
+static int deque_mt_try(struct deque_mt *d, enum deque_mt_op op, void **data)
+{
+	switch (op) {
+	case deque_mt_op_push:
+		return deque_mt_try_push(d, *data);
+	case deque_mt_op_pop:
+		return deque_mt_try_pop(d, data);
+	case deque_mt_op_unshift:
+		return deque_mt_try_unshift(d, *data);
+	case deque_mt_op_shift:
+		return deque_mt_try_shift(d, data);
+	}
+	return EINVAL;
+}
+
+/* must not hold any lock: signal a waiter, unless all were signalled */
+static void deque_mt_wake(struct deque_mt *d, struct deque_mt_waiters *w)
+{
+	if (__atomic_load_n(&w->waiting, __ATOMIC_RELAXED)
+	    <= __atomic_load_n(&w->woken, __ATOMIC_RELAXED)) {
+		return;
+	}
+	pthread_mutex_lock(&d->wait_lock);
+	if (w->waiting > w->woken) {
+		__atomic_store_n(&w->woken, w->woken + 1, __ATOMIC_RELAXED);
+		pthread_cond_signal(&w->cond);
+	}
+	pthread_mutex_unlock(&d->wait_lock);
+}
+
+static void deque_mt_deadline(struct timespec *deadline, long timeout_ms)
+{
+	clock_gettime(Deque_mt_clock, deadline);
+	deadline->tv_sec += timeout_ms / 1000;
+	deadline->tv_nsec += (timeout_ms % 1000) * 1000L * 1000L;
+	if (deadline->tv_nsec >= 1000L * 1000L * 1000L) {
+		deadline->tv_nsec -= 1000L * 1000L * 1000L;
+		++deadline->tv_sec;
+	}
+}
+
+static int deque_mt_wait(struct deque_mt *d, enum deque_mt_op op,
+			 void **data, long timeout_ms)
+{
+	int adding = (op == deque_mt_op_push || op == deque_mt_op_unshift);
+	struct deque_mt_waiters *w = adding ? &d->producers : &d->consumers;
+	struct timespec deadline;
+	int rv, err = 0;
+
+	rv = deque_mt_try(d, op, data);
+	if (rv == EAGAIN && timeout_ms != 0) {
+		if (timeout_ms > 0) {
+			deque_mt_deadline(&deadline, timeout_ms);
+		}
+		pthread_mutex_lock(&d->wait_lock);
+		__atomic_store_n(&w->waiting, w->waiting + 1,
+				 __ATOMIC_RELAXED);
+		while ((rv = deque_mt_try(d, op, data)) == EAGAIN
+		       && err != ETIMEDOUT) {
+			if (timeout_ms > 0) {
+				err = pthread_cond_timedwait(&w->cond,
+							     &d->wait_lock,
+							     &deadline);
+			} else {
+				pthread_cond_wait(&w->cond, &d->wait_lock);
+			}
+			if (w->woken) {
+				__atomic_store_n(&w->woken, w->woken - 1,
+						 __ATOMIC_RELAXED);
+			}
+		}
+		__atomic_store_n(&w->waiting, w->waiting - 1,
+				 __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&d->wait_lock);
+	}
+
+	if (rv == EAGAIN) {
+		return ETIMEDOUT;
+	}
+	if (!rv) {
+		/* an item was added or removed: let the other side know */
+		deque_mt_wake(d, adding ? &d->consumers : &d->producers);
+	}
+	return rv;
+}
+
+int deque_mt_push_wait(struct deque_mt *d, void *data, long timeout_ms)
+{
+	return deque_mt_wait(d, deque_mt_op_push, &data, timeout_ms);
+}
+
+int deque_mt_pop_wait(struct deque_mt *d, void **out, long timeout_ms)
+{
+	return deque_mt_wait(d, deque_mt_op_pop, out, timeout_ms);
+}
+
+int deque_mt_unshift_wait(struct deque_mt *d, void *data, long timeout_ms)
+{
+	return deque_mt_wait(d, deque_mt_op_unshift, &data, timeout_ms);
+}
+
+int deque_mt_shift_wait(struct deque_mt *d, void **out, long timeout_ms)
+{
+	return deque_mt_wait(d, deque_mt_op_shift, out, timeout_ms);
+}
+
+/* without a max_size, these never wait */
+struct deque_mt *deque_mt_push(struct deque_mt *d, void *data)
+{
+	return deque_mt_push_wait(d, data, -1) ? NULL : d;
+}
+
+void *deque_mt_pop(struct deque_mt *d)
+{
+	void *data = NULL;
+
+	deque_mt_pop_wait(d, &data, 0);
+	return data;
+}
+
+struct deque_mt *deque_mt_unshift(struct deque_mt *d, void *data)
+{
+	return deque_mt_unshift_wait(d, data, -1) ? NULL : d;
+}
+
+void *deque_mt_shift(struct deque_mt *d)
+{
+	void *data = NULL;
+
+	deque_mt_shift_wait(d, &data, 0);
+	return data;
+}
+
+size_t deque_mt_size(struct deque_mt *d)
+{
+	size_t first, end;
+
+	/* first may pass end between the two loads, read end last */
+	first = deque_mt_load(deque_mt_bottom(d)->pos);
+	end = deque_mt_load(deque_mt_top(d)->pos);
+	if ((end - first) > deque_mt_len(d)) {
+		return 0;
+	}
+	return end - first;
+}
+
+void deque_mt_set_max_size(struct deque_mt *d, size_t max_size)
+{
+	deque_mt_lock_both(d);
+	d->max_size = max_size;
+	deque_mt_unlock_both(d);
+
+	/* a larger max_size may let waiting producers in */
+	pthread_mutex_lock(&d->wait_lock);
+	__atomic_store_n(&d->producers.woken, d->producers.waiting,
+			 __ATOMIC_RELAXED);
+	pthread_cond_broadcast(&d->producers.cond);
+	pthread_mutex_unlock(&d->wait_lock);
+}
+
+static void deque_mt_waiters_init(struct deque_mt_waiters *w)
+{
+	pthread_condattr_t attr;
+
+	pthread_condattr_init(&attr);
+#if Deque_mt_monotonic
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+	pthread_cond_init(&w->cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+struct deque_mt *deque_mt_init(struct deque_mt *d, size_t data_space_len,
+			       struct eembed_allocator *ea)
+{
+	size_t len = 4;
+
+	if (!ea) {
+		ea = eembed_global_allocator;
+	}
+
+	if (!data_space_len) {
+		data_space_len = Deque_default_len;
+	}
+	while (len < data_space_len && (len * 2) > len) {
+		len *= 2;
+	}
+
+	if (d) {
+		eembed_memset(d, 0x00, sizeof(struct deque_mt));
+	} else {
+		d = (struct deque_mt *)ea->calloc(ea, 1,
+						  sizeof(struct deque_mt));
+		if (!d) {
+			return NULL;
+		}
+		d->deque_needs_free = 1;
+	}
+
+	d->data_space = (void **)ea->calloc(ea, len, sizeof(void *));
+	if (!d->data_space) {
+		if (d->deque_needs_free) {
+			ea->free(ea, d);
+		}
+		return NULL;
+	}
+	d->mask = len - 1;
+	d->ea = ea;
+
+	pthread_mutex_init(&deque_mt_bottom(d)->lock, NULL);
+	pthread_mutex_init(&deque_mt_top(d)->lock, NULL);
+	pthread_mutex_init(&d->wait_lock, NULL);
+	deque_mt_waiters_init(&d->consumers);
+	deque_mt_waiters_init(&d->producers);
+
+	return d;
+}
+
+struct deque_mt *deque_mt_new(void)
+{
+	return deque_mt_init(NULL, 0, NULL);
+}
+
+struct deque_mt *deque_mt_new_custom_allocator(struct eembed_allocator *ea)
+{
+	return deque_mt_init(NULL, 0, ea);
+}
+
+void deque_mt_free(struct deque_mt *d)
+{
+	struct eembed_allocator *ea = NULL;
+
+	if (!d) {
+		return;
+	}
+
+	eembed_assert(d->ea);
+
+	ea = d->ea;
+
+	pthread_cond_destroy(&d->producers.cond);
+	pthread_cond_destroy(&d->consumers.cond);
+	pthread_mutex_destroy(&d->wait_lock);
+	pthread_mutex_destroy(&deque_mt_top(d)->lock);
+	pthread_mutex_destroy(&deque_mt_bottom(d)->lock);
+
+	ea->free(ea, d->data_space);
+	d->data_space = NULL;
+	d->mask = 0;
+
+	if (d->deque_needs_free) {
+		ea->free(ea, d);
+	}
+}
@@ -0,0 +1,108 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-mt.h thread-safe Double-Ended QUEue interface */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef DEQUE_MT_H
+#define DEQUE_MT_H
+
+#include "deque.h"
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   The top (push, pop) and the bottom (shift, unshift) each have their
+   own lock, and each lock and position is on its own cache line. When
+   there are more than a couple of items, and more than a couple of free
+   slots, operations at opposite ends do not contend. Otherwise, and to
+   grow the data_space, both locks are taken: always bottom, then top.
+*/
+struct deque_mt_end {
+	pthread_mutex_t lock;
+	/* read by the other end with __atomic_load_n */
+	size_t pos;
+};
+
+/*
+   Threads which wait are counted, so that the other side takes the
+   wait_lock and signals only if there is a waiter which has not yet
+   been signalled: a burst of items wakes each waiter once.
+*/
+struct deque_mt_waiters {
+	pthread_cond_t cond;
+	/* read without the wait_lock with __atomic_load_n */
+	size_t waiting;
+	size_t woken;
+};
+
+struct deque_mt {
+	union {
+		struct deque_mt_end end;
+		unsigned char line[2 * Deque_cache_line];
+	} bottom;
+	union {
+		struct deque_mt_end end;
+		unsigned char line[2 * Deque_cache_line];
+	} top;
+
+	/* changed only while holding both locks */
+	size_t mask;
+	void **data_space;
+	struct eembed_allocator *ea;
+	int deque_needs_free;
+
+	/* if non-zero, push and unshift wait while there are this many */
+	size_t max_size;
+
+	pthread_mutex_t wait_lock;
+	struct deque_mt_waiters consumers;
+	struct deque_mt_waiters producers;
+};
+
+struct deque_mt *deque_mt_init(struct deque_mt *d, size_t data_space_len,
+			       struct eembed_allocator *ea);
+
+struct deque_mt *deque_mt_new(void);
+struct deque_mt *deque_mt_new_custom_allocator(struct eembed_allocator *ea);
+
+void deque_mt_free(struct deque_mt *d);
+
+/* if max_size is not zero, then push and unshift block while full */
+void deque_mt_set_max_size(struct deque_mt *d, size_t max_size);
+
+/* add items to the end of queue (or top of stack): */
+struct deque_mt *deque_mt_push(struct deque_mt *d, void *data);
+
+/* remove items from end of queue (or top of stack): */
+void *deque_mt_pop(struct deque_mt *d);
+
+/* prepend items to queue (or bottom of stack): */
+struct deque_mt *deque_mt_unshift(struct deque_mt *d, void *data);
+
+/* remove item from front of queue (or bottom of stack): */
+void *deque_mt_shift(struct deque_mt *d);
+
+/* the number of items, which may already have changed */
+size_t deque_mt_size(struct deque_mt *d);
+
+/*
+   These wait for an item, or for room if there is a max_size, for up
+   to timeout_ms milliseconds; zero does not wait, and negative waits
+   without a timeout. Items are passed via out, thus a stored NULL is
+   returned like any other item.
+
+   returns 0 on success, ETIMEDOUT if nothing arrived (or no room was
+   made) before the timeout, or ENOMEM if the push could not grow.
+*/
+int deque_mt_shift_wait(struct deque_mt *d, void **out, long timeout_ms);
+int deque_mt_pop_wait(struct deque_mt *d, void **out, long timeout_ms);
+int deque_mt_push_wait(struct deque_mt *d, void *data, long timeout_ms);
+int deque_mt_unshift_wait(struct deque_mt *d, void *data, long timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEQUE_MT_H */
@@ -0,0 +1,165 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-parallel.c iterating a Double-Ended QUEue on many threads */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+/*
+   The chunks are claimed in order from a shared counter, thus a thread
+   which is given cheap items simply claims more chunks. When func
+   returns non-zero, the index is recorded if it is the lowest so far;
+   any chunk or item after the lowest recorded index is not started,
+   and as chunks are claimed in order, the thread is then done.
+*/
+#include "deque-parallel.h"
+#include "eembed.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#define deque_parallel_load(val) __atomic_load_n(&(val), __ATOMIC_ACQUIRE)
+#define deque_parallel_store(val, x) \
+	__atomic_store_n(&(val), (x), __ATOMIC_RELEASE)
+
+/* chunks per thread, that threads which finish early can take more */
+#define Deque_parallel_chunks 8
+
+struct deque_parallel_job {
+	struct deque *d;
+	deque_iterator_func func;
+	void *context;
+
+	/* the items, see deque_as_spans */
+	void **a;
+	size_t a_len;
+	void **b;
+	size_t used;
+
+	size_t chunk_len;
+	/* claimed with __atomic_fetch_add */
+	size_t next_chunk;
+
+	/* the lowest index for which func returned non-zero, or
+	   Deque_not_found; written while holding the lock */
+	size_t halt_index;
+	int halt_result;
+	pthread_mutex_t lock;
+};
+
+static void deque_parallel_halt(struct deque_parallel_job *job, size_t i,
+				int result)
+{
+	pthread_mutex_lock(&job->lock);
+	if (i < job->halt_index) {
+		job->halt_result = result;
+		deque_parallel_store(job->halt_index, i);
+	}
+	pthread_mutex_unlock(&job->lock);
+}
+
+static void deque_parallel_run(struct deque_parallel_job *job)
+{
+	size_t chunk, from, to, i;
+	void *each = NULL;
+	int result = 0;
+
+	for (;;) {
+		chunk = __atomic_fetch_add(&job->next_chunk, 1,
+					   __ATOMIC_RELAXED);
+		from = chunk * job->chunk_len;
+		if (from >= job->used
+		    || from > deque_parallel_load(job->halt_index)) {
+			return;
+		}
+		to = from + job->chunk_len;
+		if (to > job->used) {
+			to = job->used;
+		}
+		for (i = from; i < to; ++i) {
+			if (i > deque_parallel_load(job->halt_index)) {
+				return;
+			}
+			if (i < job->a_len) {
+				each = job->a[i];
+			} else {
+				each = job->b[i - job->a_len];
+			}
+			result = job->func(job->d, each, job->context);
+			if (result) {
+				deque_parallel_halt(job, i, result);
+				return;
+			}
+		}
+	}
+}
+
+static void *deque_parallel_worker(void *arg)
+{
+	deque_parallel_run((struct deque_parallel_job *)arg);
+	return NULL;
+}
+
+static size_t deque_parallel_cpus(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cpus > 0) {
+		return (size_t)cpus;
+	}
+#endif
+	return 1;
+}
+
+int deque_parallel_for_each(struct deque *d, deque_iterator_func func,
+			    void *context, size_t nthreads)
+{
+	struct deque_parallel_job job;
+	pthread_t threads[Deque_parallel_max_threads];
+	size_t b_len, chunks, started, i;
+
+	eembed_memset(&job, 0x00, sizeof(struct deque_parallel_job));
+	deque_as_spans(d, &job.a, &job.a_len, &job.b, &b_len);
+	job.used = job.a_len + b_len;
+
+	if (!nthreads) {
+		nthreads = deque_parallel_cpus();
+	}
+	if (nthreads > Deque_parallel_max_threads) {
+		nthreads = Deque_parallel_max_threads;
+	}
+
+	job.chunk_len = job.used / (nthreads * Deque_parallel_chunks);
+	if (job.chunk_len < Deque_parallel_min_chunk) {
+		job.chunk_len = Deque_parallel_min_chunk;
+	}
+	chunks = (job.used + job.chunk_len - 1) / job.chunk_len;
+	if (nthreads > chunks) {
+		nthreads = chunks;
+	}
+	if (nthreads < 2) {
+		return deque_for_each(d, func, context);
+	}
+
+	job.d = d;
+	job.func = func;
+	job.context = context;
+	job.next_chunk = 0;
+	job.halt_index = Deque_not_found;
+	job.halt_result = 0;
+	if (pthread_mutex_init(&job.lock, NULL)) {
+		return deque_for_each(d, func, context);
+	}
+
+	started = 0;
+	for (i = 0; i < nthreads - 1; ++i) {
+		if (pthread_create(&threads[started], NULL,
+				   deque_parallel_worker, &job) == 0) {
+			++started;
+		}
+	}
+	deque_parallel_run(&job);
+	for (i = 0; i < started; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+
+	pthread_mutex_destroy(&job.lock);
+	return job.halt_result;
+}
@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-parallel.h iterating a Double-Ended QUEue on many threads */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef DEQUE_PARALLEL_H
+#define DEQUE_PARALLEL_H
+
+#include "deque.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the fewest items in a chunk; smaller deques use fewer threads */
+#ifndef Deque_parallel_min_chunk
+#define Deque_parallel_min_chunk 1024
+#endif
+
+/* nthreads is limited to this many */
+#ifndef Deque_parallel_max_threads
+#define Deque_parallel_max_threads 256
+#endif
+
+/*
+   As deque_for_each, but the items are split in to chunks, which are
+   claimed in order by nthreads threads: the caller, and nthreads - 1
+   started for the call. If nthreads is 0, then one per online CPU.
+
+   The func is called concurrently, thus it must be thread-safe, and
+   the deque must not be changed until this returns. The result is that
+   of the lowest index for which func returned non-zero, as it would be
+   from deque_for_each. Once an item halts the iteration, no items after
+   it are started, but items after it which were already started, on
+   other threads, are finished.
+
+   If a thread can not be started, the others do its share.
+*/
+int deque_parallel_for_each(struct deque *d, deque_iterator_func func,
+			    void *context, size_t nthreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEQUE_PARALLEL_H */
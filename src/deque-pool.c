@@ -0,0 +1,267 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-pool.c recycling many short-lived Double-Ended QUEues */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+/*
+   Each block is a struct deque followed by data_space_len slots. The
+   blocks which are not in use are either in the cache of some thread,
+   or in the pool's free list, which is linked through the blocks.
+
+   A thread's cache is found with pthread_getspecific, and is created
+   the first time the thread uses the pool. When the thread exits, the
+   key destructor returns the cached blocks to the free list. The pool
+   also links all of the caches, for deque_pool_destroy.
+*/
+#include "deque-pool.h"
+#include "eembed.h"
+
+#if Deque_threads
+#include <pthread.h>
+#endif
+
+/* the first bytes of a block, while it is not in use */
+struct deque_pool_link {
+	struct deque_pool_link *next;
+};
+
+#if Deque_threads
+struct deque_pool_cache {
+	struct deque_pool *pool;
+	struct deque_pool_cache *next;
+	size_t count;
+	struct deque *blocks[Deque_pool_cache_len];
+};
+#endif
+
+struct deque_pool {
+	struct eembed_allocator *ea;
+	size_t data_space_len;
+	unsigned options;
+
+	struct deque_pool_link *free_list;
+#if Deque_threads
+	pthread_mutex_t lock;
+	pthread_key_t key;
+	struct deque_pool_cache *caches;
+#endif
+};
+
+#define deque_pool_slots(d) ((void **)(((struct deque *)(d)) + 1))
+
+static struct deque *deque_pool_alloc(struct deque_pool *pool)
+{
+	size_t size = sizeof(struct deque)
+	    + (sizeof(void *) * pool->data_space_len);
+
+	return (struct deque *)pool->ea->malloc(pool->ea, size);
+}
+
+#if Deque_threads
+#define deque_pool_lock(pool) pthread_mutex_lock(&(pool)->lock)
+#define deque_pool_unlock(pool) pthread_mutex_unlock(&(pool)->lock)
+#else
+#define deque_pool_lock(pool) do { } while (0)
+#define deque_pool_unlock(pool) do { } while (0)
+#endif
+
+/* take a block from the free list, or NULL */
+static struct deque *deque_pool_take(struct deque_pool *pool)
+{
+	struct deque_pool_link *link = NULL;
+
+	deque_pool_lock(pool);
+	link = pool->free_list;
+	if (link) {
+		pool->free_list = link->next;
+	}
+	deque_pool_unlock(pool);
+	return (struct deque *)link;
+}
+
+static void deque_pool_give(struct deque_pool *pool, struct deque *d)
+{
+	struct deque_pool_link *link = (struct deque_pool_link *)d;
+
+	deque_pool_lock(pool);
+	link->next = pool->free_list;
+	pool->free_list = link;
+	deque_pool_unlock(pool);
+}
+
+#if Deque_threads
+/* move n of the cached blocks to the free list; holding the lock */
+static void deque_pool_cache_flush(struct deque_pool_cache *cache, size_t n)
+{
+	struct deque_pool *pool = cache->pool;
+	struct deque_pool_link *link = NULL;
+
+	while (n--) {
+		link = (struct deque_pool_link *)cache->blocks[--cache->count];
+		link->next = pool->free_list;
+		pool->free_list = link;
+	}
+}
+
+static void deque_pool_cache_exit(void *arg)
+{
+	struct deque_pool_cache *cache = (struct deque_pool_cache *)arg;
+	struct deque_pool *pool = cache->pool;
+	struct deque_pool_cache **each = NULL;
+
+	deque_pool_lock(pool);
+	deque_pool_cache_flush(cache, cache->count);
+	for (each = &pool->caches; *each; each = &(*each)->next) {
+		if (*each == cache) {
+			*each = cache->next;
+			break;
+		}
+	}
+	deque_pool_unlock(pool);
+	pool->ea->free(pool->ea, cache);
+}
+
+/* the cache of this thread, or NULL if it could not be created */
+static struct deque_pool_cache *deque_pool_cache(struct deque_pool *pool)
+{
+	struct deque_pool_cache *cache = NULL;
+
+	cache = (struct deque_pool_cache *)pthread_getspecific(pool->key);
+	if (cache) {
+		return cache;
+	}
+	cache = (struct deque_pool_cache *)
+	    pool->ea->calloc(pool->ea, 1, sizeof(struct deque_pool_cache));
+	if (!cache) {
+		return NULL;
+	}
+	cache->pool = pool;
+	if (pthread_setspecific(pool->key, cache)) {
+		pool->ea->free(pool->ea, cache);
+		return NULL;
+	}
+	deque_pool_lock(pool);
+	cache->next = pool->caches;
+	pool->caches = cache;
+	deque_pool_unlock(pool);
+	return cache;
+}
+#endif
+
+struct deque_pool *deque_pool_create(struct eembed_allocator *ea,
+				     size_t data_space_len, unsigned options)
+{
+	struct deque_pool *pool = NULL;
+
+	if (!ea) {
+		ea = eembed_global_allocator;
+	}
+	pool = (struct deque_pool *)
+	    ea->calloc(ea, 1, sizeof(struct deque_pool));
+	if (!pool) {
+		return NULL;
+	}
+	pool->ea = ea;
+	pool->data_space_len = data_space_len ? data_space_len
+	    : Deque_default_len;
+	pool->options = options;
+#if Deque_threads
+	if (pthread_key_create(&pool->key, deque_pool_cache_exit)) {
+		ea->free(ea, pool);
+		return NULL;
+	}
+	pthread_mutex_init(&pool->lock, NULL);
+#endif
+	return pool;
+}
+
+struct deque *deque_pool_get(struct deque_pool *pool)
+{
+	struct deque *d = NULL;
+#if Deque_threads
+	struct deque_pool_cache *cache = deque_pool_cache(pool);
+	struct deque_pool_link *link = NULL;
+
+	if (cache && !cache->count) {
+		/* refill half of the cache */
+		deque_pool_lock(pool);
+		while (cache->count < Deque_pool_cache_len / 2
+		       && (link = pool->free_list) != NULL) {
+			pool->free_list = link->next;
+			cache->blocks[cache->count++] = (struct deque *)link;
+		}
+		deque_pool_unlock(pool);
+	}
+	if (cache && cache->count) {
+		d = cache->blocks[--cache->count];
+	}
+#endif
+	if (!d) {
+		d = deque_pool_take(pool);
+	}
+	if (!d) {
+		d = deque_pool_alloc(pool);
+		if (!d) {
+			return NULL;
+		}
+	}
+	return deque_init_options(d, deque_pool_slots(d),
+				  pool->data_space_len, pool->ea,
+				  pool->options);
+}
+
+void deque_pool_put(struct deque_pool *pool, struct deque *d)
+{
+#if Deque_threads
+	struct deque_pool_cache *cache = NULL;
+#endif
+
+	if (!d) {
+		return;
+	}
+	/* free a data_space which was grown, or scrub */
+	if (d->data_space != deque_pool_slots(d) || d->flags.secure_scrub) {
+		deque_free(d);
+	}
+#if Deque_threads
+	cache = deque_pool_cache(pool);
+	if (cache) {
+		if (cache->count == Deque_pool_cache_len) {
+			/* give half of the cache back to the pool */
+			deque_pool_lock(pool);
+			deque_pool_cache_flush(cache, Deque_pool_cache_len / 2);
+			deque_pool_unlock(pool);
+		}
+		cache->blocks[cache->count++] = d;
+		return;
+	}
+#endif
+	deque_pool_give(pool, d);
+}
+
+void deque_pool_destroy(struct deque_pool *pool)
+{
+	struct eembed_allocator *ea = NULL;
+	struct deque_pool_link *link = NULL;
+#if Deque_threads
+	struct deque_pool_cache *cache = NULL;
+#endif
+
+	if (!pool) {
+		return;
+	}
+	ea = pool->ea;
+#if Deque_threads
+	pthread_key_delete(pool->key);
+	while ((cache = pool->caches) != NULL) {
+		pool->caches = cache->next;
+		deque_pool_cache_flush(cache, cache->count);
+		ea->free(ea, cache);
+	}
+	pthread_mutex_destroy(&pool->lock);
+#endif
+	while ((link = pool->free_list) != NULL) {
+		pool->free_list = link->next;
+		ea->free(ea, link);
+	}
+	ea->free(ea, pool);
+}
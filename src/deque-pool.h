@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-pool.h recycling many short-lived Double-Ended QUEues */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef DEQUE_POOL_H
+#define DEQUE_POOL_H
+
+#include "deque.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   For programs which create and free very many small deques: each
+   deque from a pool is one allocation, the struct deque followed by
+   its data_space, and when put back it is kept for the next get,
+   rather than freed. A deque which grows past its initial data_space
+   is given an allocated one as usual, which is freed when it is put.
+
+   If libdeque is built with threads, the pool may be shared: each
+   thread keeps a small cache of deques, and only takes the pool lock
+   to move half a cache to or from the pool, thus in a steady state of
+   gets and puts neither the lock nor the allocator is used.
+*/
+
+/* deques in each per-thread cache */
+#ifndef Deque_pool_cache_len
+#define Deque_pool_cache_len 32
+#endif
+
+struct deque_pool;
+
+/* a NULL ea uses eembed_global_allocator, a data_space_len of zero uses
+   Deque_default_len; the options are those of deque_init_options */
+struct deque_pool *deque_pool_create(struct eembed_allocator *ea,
+				     size_t data_space_len, unsigned options);
+
+/* an empty deque, or NULL if out of memory */
+struct deque *deque_pool_get(struct deque_pool *pool);
+
+/* rather than deque_free; any thread may put a deque from the pool */
+void deque_pool_put(struct deque_pool *pool, struct deque *d);
+
+/* frees the pool and all the deques which were put back; any deques
+   not put back are lost, and no other thread may be using the pool */
+void deque_pool_destroy(struct deque_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEQUE_POOL_H */
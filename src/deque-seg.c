@@ -0,0 +1,328 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-seg.c segmented Double-Ended QUEue */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+/*
+   The items occupy the positions first_pos to (first_pos + size) across
+   the blocks of the map, thus the item at position pos is in the block
+   (pos >> block_shift) at slot (pos & block_mask). first_pos is always
+   within the first block, and the last block always holds at least one
+   item; an empty deque has either no blocks, or one block with first_pos
+   in the middle, to leave room at both ends.
+*/
+#include "deque-seg.h"
+#include "eembed.h"
+
+#define deque_seg_block_len(d) ((d)->block_mask + 1)
+#define deque_seg_blocks(d) deque_size(&(d)->map)
+#define deque_seg_block(d, i) ((void **)deque_peek_bottom(&(d)->map, (i)))
+
+#define deque_seg_assert(d) do { \
+	eembed_assert(d != NULL); \
+	eembed_assert(d->ea != NULL); \
+	eembed_assert(d->first_pos < deque_seg_block_len(d)); \
+	eembed_assert(d->first_pos + d->size \
+		      <= (deque_seg_blocks(d) << d->block_shift)); \
+} while (0)
+
+static void **deque_seg_get_block(struct deque_seg *d)
+{
+	void **block = d->spare;
+
+	if (block) {
+		d->spare = NULL;
+		return block;
+	}
+	return (void **)d->ea->malloc(d->ea,
+				      sizeof(void *) * deque_seg_block_len(d));
+}
+
+static void deque_seg_put_block(struct deque_seg *d, void **block)
+{
+	if (!d->spare) {
+		d->spare = block;
+	} else {
+		d->ea->free(d->ea, block);
+	}
+}
+
+/* add a block to the front or the end of the map */
+static struct deque_seg *deque_seg_add_block(struct deque_seg *d, int front)
+{
+	void **block = deque_seg_get_block(d);
+
+	if (!block) {
+		return NULL;
+	}
+	if (!(front ? deque_unshift(&d->map, block)
+	      : deque_push(&d->map, block))) {
+		deque_seg_put_block(d, block);
+		return NULL;
+	}
+	return d;
+}
+
+/* the first block, with first_pos in the middle */
+static struct deque_seg *deque_seg_first_block(struct deque_seg *d)
+{
+	if (!deque_seg_add_block(d, 0)) {
+		return NULL;
+	}
+	d->first_pos = deque_seg_block_len(d) / 2;
+	return d;
+}
+
+struct deque_seg *deque_seg_push(struct deque_seg *d, void *data)
+{
+	size_t end = 0;
+	void **block = NULL;
+
+	deque_seg_assert(d);
+
+	if (!deque_seg_blocks(d) && !deque_seg_first_block(d)) {
+		return NULL;
+	}
+	end = d->first_pos + d->size;
+	if (end == (deque_seg_blocks(d) << d->block_shift)) {
+		if (!deque_seg_add_block(d, 0)) {
+			return NULL;
+		}
+	}
+	block = (void **)deque_peek_top(&d->map, 0);
+	block[end & d->block_mask] = data;
+	++d->size;
+
+	return d;
+}
+
+void *deque_seg_pop(struct deque_seg *d)
+{
+	void *data = NULL;
+	void **block = NULL;
+	size_t end = 0;
+
+	deque_seg_assert(d);
+
+	if (!d->size) {
+		return NULL;
+	}
+
+	--d->size;
+	end = d->first_pos + d->size;
+	block = (void **)deque_peek_top(&d->map, 0);
+	data = block[end & d->block_mask];
+	block[end & d->block_mask] = NULL;
+
+	if (!d->size) {
+		/* the one remaining block */
+		d->first_pos = deque_seg_block_len(d) / 2;
+	} else if (!(end & d->block_mask)) {
+		/* the last block is now empty */
+		deque_seg_put_block(d, (void **)deque_pop(&d->map));
+	}
+
+	return data;
+}
+
+struct deque_seg *deque_seg_unshift(struct deque_seg *d, void *data)
+{
+	void **block = NULL;
+
+	deque_seg_assert(d);
+
+	if (!deque_seg_blocks(d) && !deque_seg_first_block(d)) {
+		return NULL;
+	}
+	if (!d->first_pos) {
+		if (!deque_seg_add_block(d, 1)) {
+			return NULL;
+		}
+		d->first_pos = deque_seg_block_len(d);
+	}
+	block = deque_seg_block(d, 0);
+	block[--d->first_pos] = data;
+	++d->size;
+
+	return d;
+}
+
+void *deque_seg_shift(struct deque_seg *d)
+{
+	void *data = NULL;
+	void **block = NULL;
+
+	deque_seg_assert(d);
+
+	if (!d->size) {
+		return NULL;
+	}
+
+	block = deque_seg_block(d, 0);
+	data = block[d->first_pos];
+	block[d->first_pos] = NULL;
+	++d->first_pos;
+	--d->size;
+
+	if (!d->size) {
+		d->first_pos = deque_seg_block_len(d) / 2;
+	} else if (d->first_pos == deque_seg_block_len(d)) {
+		/* the first block is now empty */
+		deque_seg_put_block(d, (void **)deque_shift(&d->map));
+		d->first_pos = 0;
+	}
+
+	return data;
+}
+
+void **deque_seg_slot(struct deque_seg *d, size_t index)
+{
+	size_t pos = 0;
+
+	deque_seg_assert(d);
+
+	if (index >= d->size) {
+		return NULL;
+	}
+	pos = d->first_pos + index;
+
+	return &deque_seg_block(d, pos >> d->block_shift)[pos & d->block_mask];
+}
+
+void *deque_seg_peek_bottom(struct deque_seg *d, size_t index)
+{
+	void **slot = deque_seg_slot(d, index);
+
+	return slot ? *slot : NULL;
+}
+
+void *deque_seg_peek_top(struct deque_seg *d, size_t index)
+{
+	deque_seg_assert(d);
+
+	if (index >= d->size) {
+		return NULL;
+	}
+
+	return deque_seg_peek_bottom(d, d->size - (index + 1));
+}
+
+size_t deque_seg_size(struct deque_seg *d)
+{
+	deque_seg_assert(d);
+
+	return d->size;
+}
+
+void deque_seg_clear(struct deque_seg *d)
+{
+	void **block = NULL;
+
+	deque_seg_assert(d);
+
+	while ((block = (void **)deque_pop(&d->map)) != NULL) {
+		deque_seg_put_block(d, block);
+	}
+	d->first_pos = 0;
+	d->size = 0;
+}
+
+int deque_seg_for_each(struct deque_seg *d, deque_seg_iterator_func func,
+		       void *context)
+{
+	void **block = NULL;
+	size_t i, pos, end;
+
+	deque_seg_assert(d);
+
+	end = 0;
+	for (i = 0; i < d->size && !end; ++i) {
+		pos = d->first_pos + i;
+		if (!block || !(pos & d->block_mask)) {
+			block = deque_seg_block(d, pos >> d->block_shift);
+		}
+		end = func(d, block[pos & d->block_mask], context);
+	}
+	return end;
+}
+
+struct deque_seg *deque_seg_init(struct deque_seg *d, size_t block_len,
+				 struct eembed_allocator *ea)
+{
+	size_t shift = 1;
+
+	if (!ea) {
+		ea = eembed_global_allocator;
+	}
+
+	if (!block_len) {
+		block_len = Deque_seg_block_len;
+	}
+	while (((size_t)1 << shift) < block_len
+	       && shift < ((sizeof(size_t) * CHAR_BIT) - 4)) {
+		++shift;
+	}
+
+	if (d) {
+		eembed_memset(d, 0x00, sizeof(struct deque_seg));
+	} else {
+		d = (struct deque_seg *)ea->calloc(ea, 1,
+						   sizeof(struct deque_seg));
+		if (!d) {
+			return NULL;
+		}
+		d->deque_needs_free = 1;
+	}
+
+	if (!deque_init_options(&d->map, NULL, 0, ea, Deque_option_ring)) {
+		if (d->deque_needs_free) {
+			ea->free(ea, d);
+		}
+		return NULL;
+	}
+	d->block_shift = shift;
+	d->block_mask = ((size_t)1 << shift) - 1;
+	d->ea = ea;
+
+	deque_seg_assert(d);
+
+	return d;
+}
+
+struct deque_seg *deque_seg_new(void)
+{
+	return deque_seg_init(NULL, 0, NULL);
+}
+
+struct deque_seg *deque_seg_new_custom_allocator(struct eembed_allocator *ea)
+{
+	return deque_seg_init(NULL, 0, ea);
+}
+
+void deque_seg_free(struct deque_seg *d)
+{
+	struct eembed_allocator *ea = NULL;
+	void **block = NULL;
+
+	if (!d) {
+		return;
+	}
+
+	eembed_assert(d->ea);
+
+	ea = d->ea;
+
+	while ((block = (void **)deque_pop(&d->map)) != NULL) {
+		ea->free(ea, block);
+	}
+	if (d->spare) {
+		ea->free(ea, d->spare);
+		d->spare = NULL;
+	}
+	deque_free(&d->map);
+	d->first_pos = 0;
+	d->size = 0;
+
+	if (d->deque_needs_free) {
+		ea->free(ea, d);
+	}
+}
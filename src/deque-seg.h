@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-seg.h segmented Double-Ended QUEue interface */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef DEQUE_SEG_H
+#define DEQUE_SEG_H
+
+#include "deque.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   For very large deques: the items are stored in fixed size blocks, and
+   a struct deque (in ring mode) holds the blocks in order, thus growing
+   adds a block without moving any items. Once stored, an item stays in
+   the same slot until it is removed, see deque_seg_slot. A block which
+   is emptied at either end is kept as a spare, for the next block.
+*/
+
+/* slots per block, rounded up to a power of two */
+#ifndef Deque_seg_block_len
+#define Deque_seg_block_len 512
+#endif
+
+struct deque_seg {
+	/* the blocks, in order: each is a (void **) of block_len slots */
+	struct deque map;
+	/* offset of the first item in the first block */
+	size_t first_pos;
+	size_t size;
+	size_t block_shift;
+	size_t block_mask;
+	/* a recycled block, if any */
+	void **spare;
+	struct eembed_allocator *ea;
+	int deque_needs_free;
+};
+
+typedef int (*deque_seg_iterator_func)(struct deque_seg *d, void *each,
+				       void *context);
+
+/* a block_len of zero uses Deque_seg_block_len */
+struct deque_seg *deque_seg_init(struct deque_seg *d, size_t block_len,
+				 struct eembed_allocator *ea);
+
+struct deque_seg *deque_seg_new(void);
+struct deque_seg *deque_seg_new_custom_allocator(struct eembed_allocator *ea);
+
+void deque_seg_free(struct deque_seg *d);
+
+/* add items to the end of queue (or top of stack): */
+struct deque_seg *deque_seg_push(struct deque_seg *d, void *data);
+
+/* remove items from end of queue (or top of stack): */
+void *deque_seg_pop(struct deque_seg *d);
+
+/* prepend items to queue (or bottom of stack): */
+struct deque_seg *deque_seg_unshift(struct deque_seg *d, void *data);
+
+/* remove item from front of queue (or bottom of stack): */
+void *deque_seg_shift(struct deque_seg *d);
+
+/* pointer to data from the end of the queue, or top of the stack */
+void *deque_seg_peek_top(struct deque_seg *d, size_t index);
+
+/* pointer to data from the front of the queue, or bottom of the stack */
+void *deque_seg_peek_bottom(struct deque_seg *d, size_t index);
+
+/* the address of the slot of the item at index from the bottom, which
+   remains valid until that item is removed; NULL if out of range */
+void **deque_seg_slot(struct deque_seg *d, size_t index);
+
+/* return the number of items in the deque */
+size_t deque_seg_size(struct deque_seg *d);
+
+/* remove all of the items, and release all but one block */
+void deque_seg_clear(struct deque_seg *d);
+
+/* internal iterator */
+int deque_seg_for_each(struct deque_seg *d, deque_seg_iterator_func func,
+		       void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEQUE_SEG_H */
@@ -0,0 +1,267 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-sort.c sorting and searching a Double-Ended QUEue in order */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+/*
+   The sort is in place, over the slots of the items: an introsort,
+   which is a quicksort with a median of three pivot, that falls back
+   to a heapsort if the partitions become too uneven, and finishes the
+   small partitions with an insertion sort. It is not stable.
+
+   A wrapped ring is first rotated, so that the items are in one run.
+*/
+#include "deque.h"
+#include "eembed.h"
+
+/* partitions of this many or fewer are insertion sorted */
+#define Deque_sort_small 16
+
+#define deque_swap(a, i, j) do { \
+	void *tmp_ = (a)[i]; \
+	(a)[i] = (a)[j]; \
+	(a)[j] = tmp_; \
+} while (0)
+
+static void deque_reverse(void **a, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n / 2; ++i) {
+		deque_swap(a, i, n - (i + 1));
+	}
+}
+
+/* if the items (and "extra" free slots after them) would wrap around
+   the end of a ring, rotate the data_space to put the first item at 0 */
+static void deque_unwrap(struct deque *d, size_t extra)
+{
+	size_t used = d->end_pos - d->first_pos;
+
+	if (d->first_pos + used + extra <= d->data_space_len) {
+		return;
+	}
+	deque_reverse(d->data_space, d->first_pos);
+	deque_reverse(d->data_space + d->first_pos,
+		      d->data_space_len - d->first_pos);
+	deque_reverse(d->data_space, d->data_space_len);
+	d->first_pos = 0;
+	d->end_pos = used;
+}
+
+static void deque_sort_insertion(void **a, size_t n, deque_compare_func cmp,
+				 void *context)
+{
+	size_t i, j;
+	void *each;
+
+	for (i = 1; i < n; ++i) {
+		each = a[i];
+		for (j = i; j > 0 && cmp(each, a[j - 1], context) < 0; --j) {
+			a[j] = a[j - 1];
+		}
+		a[j] = each;
+	}
+}
+
+static void deque_sift_down(void **a, size_t i, size_t n,
+			    deque_compare_func cmp, void *context)
+{
+	size_t child;
+
+	while ((child = (2 * i) + 1) < n) {
+		if (child + 1 < n && cmp(a[child], a[child + 1], context) < 0) {
+			++child;
+		}
+		if (cmp(a[i], a[child], context) >= 0) {
+			return;
+		}
+		deque_swap(a, i, child);
+		i = child;
+	}
+}
+
+static void deque_sort_heap(void **a, size_t n, deque_compare_func cmp,
+			    void *context)
+{
+	size_t i;
+
+	for (i = n / 2; i > 0; --i) {
+		deque_sift_down(a, i - 1, n, cmp, context);
+	}
+	for (i = n; i > 1; --i) {
+		deque_swap(a, 0, i - 1);
+		deque_sift_down(a, 0, i - 1, cmp, context);
+	}
+}
+
+/* partition around the median of the first, middle, and last items;
+   returns i, where [0, i) are not greater, and [i, n) are not less,
+   and neither is empty */
+static size_t deque_partition(void **a, size_t n, deque_compare_func cmp,
+			      void *context)
+{
+	size_t mid = n / 2;
+	size_t i = 0;
+	size_t j = n - 1;
+	void *pivot;
+
+	if (cmp(a[mid], a[0], context) < 0) {
+		deque_swap(a, mid, 0);
+	}
+	if (cmp(a[n - 1], a[mid], context) < 0) {
+		deque_swap(a, n - 1, mid);
+		if (cmp(a[mid], a[0], context) < 0) {
+			deque_swap(a, mid, 0);
+		}
+	}
+	pivot = a[mid];
+
+	/* a[0] and a[n - 1] stop the scans in the first pass, and after
+	   that the swapped items do */
+	for (;;) {
+		while (cmp(a[i], pivot, context) < 0) {
+			++i;
+		}
+		while (cmp(pivot, a[j], context) < 0) {
+			--j;
+		}
+		if (i >= j) {
+			return i;
+		}
+		deque_swap(a, i, j);
+		++i;
+		--j;
+	}
+}
+
+static void deque_sort_intro(void **a, size_t n, size_t depth,
+			     deque_compare_func cmp, void *context)
+{
+	size_t i;
+
+	while (n > Deque_sort_small) {
+		if (!depth) {
+			deque_sort_heap(a, n, cmp, context);
+			return;
+		}
+		--depth;
+		i = deque_partition(a, n, cmp, context);
+		/* recurse in to the smaller side, thus the stack is log n */
+		if (i < n - i) {
+			deque_sort_intro(a, i, depth, cmp, context);
+			a += i;
+			n -= i;
+		} else {
+			deque_sort_intro(a + i, n - i, depth, cmp, context);
+			n = i;
+		}
+	}
+	deque_sort_insertion(a, n, cmp, context);
+}
+
+void deque_sort(struct deque *d, deque_compare_func cmp, void *context)
+{
+	size_t used = 0;
+	size_t depth = 0;
+
+	used = deque_size(d);
+	if (used < 2) {
+		return;
+	}
+	deque_unwrap(d, 0);
+
+	/* 2 * log2(n) */
+	for (depth = 0; (used >> (depth / 2)) > 1; ++depth) {
+		;
+	}
+	deque_sort_intro(d->data_space + d->first_pos, used, depth, cmp,
+			 context);
+}
+
+/* the first index at which the item there is not less than the item,
+   or, if "upper", at which the item there is greater than the item */
+static size_t deque_bound(struct deque *d, void *item, int upper,
+			  deque_compare_func cmp, void *context)
+{
+	size_t lo = 0;
+	size_t hi = deque_size(d);
+	size_t mid = 0;
+	int c = 0;
+
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2);
+		c = cmp(deque_peek_bottom(d, mid), item, context);
+		if (c < 0 || (upper && c == 0)) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+size_t deque_lower_bound(struct deque *d, void *item, deque_compare_func cmp,
+			 void *context)
+{
+	return deque_bound(d, item, 0, cmp, context);
+}
+
+size_t deque_upper_bound(struct deque *d, void *item, deque_compare_func cmp,
+			 void *context)
+{
+	return deque_bound(d, item, 1, cmp, context);
+}
+
+struct deque *deque_insert_sorted(struct deque *d, void *item,
+				  deque_compare_func cmp, void *context)
+{
+	return deque_insert_at(d, deque_upper_bound(d, item, cmp, context),
+			       item);
+}
+
+struct deque *deque_merge(struct deque *dst, struct deque *src,
+			  deque_compare_func cmp, void *context)
+{
+	struct deque_cursor c;
+	size_t n, m, k;
+	void **a, **from;
+
+	if (dst == src) {
+		return NULL;
+	}
+	n = deque_size(dst);
+	m = deque_size(src);
+	if (!m) {
+		return dst;
+	}
+	if (!deque_reserve(dst, 0, m)) {
+		return NULL;
+	}
+	deque_unwrap(dst, m);
+
+	/* from the top down, in to the free slots after the dst items; of
+	   equal items, those from dst stay before those from src */
+	a = dst->data_space + dst->first_pos;
+	deque_cursor_init(&c, src, m);
+	from = deque_cursor_prev(&c);
+	for (k = n + m; from; --k) {
+		if (n && cmp(*from, a[n - 1], context) < 0) {
+			a[k - 1] = a[--n];
+		} else {
+			a[k - 1] = *from;
+			from = deque_cursor_prev(&c);
+		}
+	}
+	dst->end_pos += m;
+
+	if (!src->flags.no_scrub) {
+		deque_as_spans(src, &a, &n, &from, &k);
+		eembed_memset(a, 0x00, sizeof(void *) * n);
+		if (k) {
+			eembed_memset(from, 0x00, sizeof(void *) * k);
+		}
+	}
+	deque_clear(src);
+
+	return dst;
+}
@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-spsc.c single-producer single-consumer queue */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+/*
+   The positions are free running, and the slot is (pos & mask). The
+   producer stores the item, then publishes end_pos with release; the
+   consumer reads end_pos with acquire before reading the item, and the
+   same in reverse for reusing a slot after first_pos is published.
+*/
+#include "deque-spsc.h"
+#include "eembed.h"
+
+#define deque_spsc_len(end) ((end).mask + 1)
+
+struct deque_spsc *deque_spsc_push(struct deque_spsc *d, void *data)
+{
+	size_t end = d->producer.p.end_pos;
+
+	if ((end - d->producer.p.cached_first_pos) ==
+	    deque_spsc_len(d->producer.p)) {
+		d->producer.p.cached_first_pos =
+		    __atomic_load_n(&d->consumer.c.first_pos,
+				    __ATOMIC_ACQUIRE);
+		if ((end - d->producer.p.cached_first_pos) ==
+		    deque_spsc_len(d->producer.p)) {
+			return NULL;
+		}
+	}
+	d->producer.p.data_space[end & d->producer.p.mask] = data;
+	__atomic_store_n(&d->producer.p.end_pos, end + 1, __ATOMIC_RELEASE);
+	return d;
+}
+
+void *deque_spsc_shift(struct deque_spsc *d)
+{
+	size_t first = d->consumer.c.first_pos;
+	void *data;
+
+	if (first == d->consumer.c.cached_end_pos) {
+		d->consumer.c.cached_end_pos =
+		    __atomic_load_n(&d->producer.p.end_pos, __ATOMIC_ACQUIRE);
+		if (first == d->consumer.c.cached_end_pos) {
+			return NULL;
+		}
+	}
+	data = d->consumer.c.data_space[first & d->consumer.c.mask];
+	__atomic_store_n(&d->consumer.c.first_pos, first + 1,
+			 __ATOMIC_RELEASE);
+	return data;
+}
+
+size_t deque_spsc_size(struct deque_spsc *d)
+{
+	size_t first, end;
+
+	first = __atomic_load_n(&d->consumer.c.first_pos, __ATOMIC_ACQUIRE);
+	end = __atomic_load_n(&d->producer.p.end_pos, __ATOMIC_ACQUIRE);
+	if ((end - first) > deque_spsc_len(d->consumer.c)) {
+		return 0;
+	}
+	return end - first;
+}
+
+size_t deque_spsc_capacity(struct deque_spsc *d)
+{
+	return deque_spsc_len(d->consumer.c);
+}
+
+struct deque_spsc *deque_spsc_new_no_allocator(unsigned char *bytes,
+					       size_t bytes_len)
+{
+	struct deque_spsc *d = NULL;
+	size_t used = eembed_align(sizeof(struct deque_spsc));
+	size_t avail = 0;
+	size_t len = 2;
+
+	if (!bytes || bytes_len < (used + (2 * sizeof(void *)))) {
+		return NULL;
+	}
+	avail = (bytes_len - used) / sizeof(void *);
+	while ((len * 2) <= avail && (len * 2) > len) {
+		len *= 2;
+	}
+
+	eembed_memset(bytes, 0x00, bytes_len);
+	d = (struct deque_spsc *)bytes;
+	d->consumer.c.data_space = (void **)(bytes + used);
+	d->consumer.c.mask = len - 1;
+	d->producer.p.data_space = d->consumer.c.data_space;
+	d->producer.p.mask = d->consumer.c.mask;
+
+	return d;
+}
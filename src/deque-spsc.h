@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-spsc.h single-producer single-consumer queue interface */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef DEQUE_SPSC_H
+#define DEQUE_SPSC_H
+
+#include "deque.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   A bounded queue within a caller-supplied byte array, for a handoff
+   between exactly two threads: one which pushes, and one which shifts.
+   Nothing is allocated, nothing is locked, and neither end ever waits
+   on the other: a push when full and a shift when empty simply fail.
+
+   Each end keeps its position, a cached copy of the position of the
+   other end, and its own copy of the mask and data_space, on its own
+   cache line. The other end's position is re-read only when the cached
+   copy says it is full or empty.
+*/
+struct deque_spsc {
+	/* written only by the consumer */
+	union {
+		struct {
+			size_t first_pos;
+			size_t cached_end_pos;
+			size_t mask;
+			void **data_space;
+		} c;
+		unsigned char line[2 * Deque_cache_line];
+	} consumer;
+
+	/* written only by the producer */
+	union {
+		struct {
+			size_t end_pos;
+			size_t cached_first_pos;
+			size_t mask;
+			void **data_space;
+		} p;
+		unsigned char line[2 * Deque_cache_line];
+	} producer;
+};
+
+/* the capacity is the largest power of two which fits in the bytes */
+struct deque_spsc *deque_spsc_new_no_allocator(unsigned char *bytes,
+					       size_t bytes_len);
+
+/* producer only: returns NULL if full */
+struct deque_spsc *deque_spsc_push(struct deque_spsc *d, void *data);
+
+/* consumer only: returns NULL if empty */
+void *deque_spsc_shift(struct deque_spsc *d);
+
+/* the number of items, which may already have changed */
+size_t deque_spsc_size(struct deque_spsc *d);
+
+size_t deque_spsc_capacity(struct deque_spsc *d);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEQUE_SPSC_H */
@@ -0,0 +1,262 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-typed.h header-only Double-Ended QUEue of a given type */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef DEQUE_TYPED_H
+#define DEQUE_TYPED_H
+
+#include "deque.h"
+#include "eembed.h"
+
+/*
+   Deque_define(name, type) defines a "struct name" holding items of
+   "type" by value, and static inline functions with the "name_" prefix,
+   which may thus be inlined and specialized in the caller:
+
+	Deque_define(deque_int, int);
+
+	struct deque_int *q = deque_int_new(NULL);
+	deque_int_push(q, 42);
+	int *top = deque_int_peek_top(q, 0);
+	int x;
+	if (deque_int_pop(q, &x)) { ... }
+	deque_int_free(q);
+
+   The layout and growth follow the default (linear) struct deque: the
+   items are kept in one run, which is re-centered when an end is full,
+   and the data_space doubles when it must grow. There is no policy,
+   ring mode, or stats; pop and shift copy the item out, if out is not
+   NULL, and return NULL if empty. Peek returns a pointer in to the
+   data_space, which is valid until the deque is next changed.
+*/
+#define Deque_define(name, type) \
+\
+struct name { \
+	size_t first_pos; \
+	size_t end_pos; \
+	size_t data_space_len; \
+	type *data_space; \
+	struct eembed_allocator *ea; \
+	int deque_needs_free; \
+}; \
+\
+typedef int (*name ## _iterator_func)(struct name *d, type *each, \
+				      void *context); \
+\
+static inline struct name *name ## _init(struct name *d, \
+					 size_t data_space_len, \
+					 struct eembed_allocator *ea) \
+{ \
+	int deque_needs_free = 0; \
+	if (!ea) { \
+		ea = eembed_global_allocator; \
+	} \
+	if (!data_space_len) { \
+		data_space_len = Deque_default_len; \
+	} \
+	if (data_space_len > ((size_t)-1) / sizeof(type)) { \
+		return NULL; \
+	} \
+	if (!d) { \
+		d = (struct name *)ea->malloc(ea, sizeof(struct name)); \
+		if (!d) { \
+			return NULL; \
+		} \
+		deque_needs_free = 1; \
+	} \
+	d->data_space = (type *)ea->malloc(ea, sizeof(type) * data_space_len); \
+	if (!d->data_space) { \
+		if (deque_needs_free) { \
+			ea->free(ea, d); \
+		} \
+		return NULL; \
+	} \
+	d->data_space_len = data_space_len; \
+	d->first_pos = Deque_default_unshift_space(data_space_len); \
+	d->end_pos = d->first_pos; \
+	d->ea = ea; \
+	d->deque_needs_free = deque_needs_free; \
+	return d; \
+} \
+\
+static inline struct name *name ## _new(struct eembed_allocator *ea) \
+{ \
+	return name ## _init(NULL, 0, ea); \
+} \
+\
+static inline void name ## _free(struct name *d) \
+{ \
+	struct eembed_allocator *ea = NULL; \
+	if (!d) { \
+		return; \
+	} \
+	ea = d->ea; \
+	ea->free(ea, d->data_space); \
+	d->data_space = NULL; \
+	d->data_space_len = 0; \
+	d->first_pos = 0; \
+	d->end_pos = 0; \
+	if (d->deque_needs_free) { \
+		ea->free(ea, d); \
+	} \
+} \
+\
+/* move the items within the data_space, to start at new_first_pos */ \
+static inline void name ## _recenter(struct name *d, size_t new_first_pos) \
+{ \
+	size_t used = d->end_pos - d->first_pos; \
+	eembed_memmove(d->data_space + new_first_pos, \
+		       d->data_space + d->first_pos, sizeof(type) * used); \
+	d->first_pos = new_first_pos; \
+	d->end_pos = new_first_pos + used; \
+} \
+\
+/* double the data_space, leaving the new space at the front or end */ \
+static inline struct name *name ## _grow(struct name *d, int unshifting) \
+{ \
+	struct eembed_allocator *ea = d->ea; \
+	size_t used = d->end_pos - d->first_pos; \
+	size_t new_len = d->data_space_len * 2; \
+	size_t slack = 0; \
+	size_t new_first_pos = 0; \
+	type *new_space = NULL; \
+	if (new_len < d->data_space_len \
+	    || new_len > ((size_t)-1) / sizeof(type)) { \
+		return NULL; \
+	} \
+	/* as deque_grow, for one slot at the front or the end */ \
+	slack = new_len - (used + 1); \
+	new_first_pos = unshifting ? (1 + slack) : (slack / 2); \
+	if (ea->realloc) { \
+		new_space = (type *)ea->realloc(ea, d->data_space, \
+						sizeof(type) * new_len); \
+		if (!new_space) { \
+			return NULL; \
+		} \
+		d->data_space = new_space; \
+		d->data_space_len = new_len; \
+		name ## _recenter(d, new_first_pos); \
+		return d; \
+	} \
+	new_space = (type *)ea->malloc(ea, sizeof(type) * new_len); \
+	if (!new_space) { \
+		return NULL; \
+	} \
+	eembed_memcpy(new_space + new_first_pos, d->data_space + d->first_pos, \
+		      sizeof(type) * used); \
+	ea->free(ea, d->data_space); \
+	d->data_space = new_space; \
+	d->data_space_len = new_len; \
+	d->first_pos = new_first_pos; \
+	d->end_pos = new_first_pos + used; \
+	return d; \
+} \
+\
+static inline struct name *name ## _push(struct name *d, type item) \
+{ \
+	if (d->end_pos == d->data_space_len) { \
+		if (d->first_pos > 1) { \
+			/* use half of the free space at the front */ \
+			name ## _recenter(d, d->first_pos / 2); \
+		} else if (!name ## _grow(d, 0)) { \
+			return NULL; \
+		} \
+	} \
+	d->data_space[d->end_pos++] = item; \
+	return d; \
+} \
+\
+static inline struct name *name ## _pop(struct name *d, type *out) \
+{ \
+	if (d->end_pos == d->first_pos) { \
+		return NULL; \
+	} \
+	--d->end_pos; \
+	if (out) { \
+		*out = d->data_space[d->end_pos]; \
+	} \
+	return d; \
+} \
+\
+static inline struct name *name ## _unshift(struct name *d, type item) \
+{ \
+	if (d->first_pos == d->end_pos) { \
+		/* put the first item in the middle */ \
+		d->first_pos = 1 + (d->data_space_len / 2); \
+		d->end_pos = d->first_pos; \
+	} else if (d->first_pos == 0) { \
+		if (d->end_pos < d->data_space_len) { \
+			/* use half of the free space at the end */ \
+			name ## _recenter(d, 1 + ((d->data_space_len \
+						   - d->end_pos) / 2)); \
+		} else if (!name ## _grow(d, 1)) { \
+			return NULL; \
+		} \
+	} \
+	d->data_space[--d->first_pos] = item; \
+	return d; \
+} \
+\
+static inline struct name *name ## _shift(struct name *d, type *out) \
+{ \
+	if (d->first_pos == d->end_pos) { \
+		return NULL; \
+	} \
+	if (out) { \
+		*out = d->data_space[d->first_pos]; \
+	} \
+	++d->first_pos; \
+	if (d->first_pos == d->end_pos) { \
+		d->first_pos = Deque_default_unshift_space(d->data_space_len); \
+		d->end_pos = d->first_pos; \
+	} \
+	return d; \
+} \
+\
+static inline type *name ## _peek_top(struct name *d, size_t index) \
+{ \
+	if (index >= (d->end_pos - d->first_pos)) { \
+		return NULL; \
+	} \
+	return d->data_space + (d->end_pos - (index + 1)); \
+} \
+\
+static inline type *name ## _peek_bottom(struct name *d, size_t index) \
+{ \
+	if (index >= (d->end_pos - d->first_pos)) { \
+		return NULL; \
+	} \
+	return d->data_space + (d->first_pos + index); \
+} \
+\
+static inline size_t name ## _size(struct name *d) \
+{ \
+	return d->end_pos - d->first_pos; \
+} \
+\
+static inline size_t name ## _capacity(struct name *d) \
+{ \
+	return d->data_space_len; \
+} \
+\
+static inline void name ## _clear(struct name *d) \
+{ \
+	d->first_pos = Deque_default_unshift_space(d->data_space_len); \
+	d->end_pos = d->first_pos; \
+} \
+\
+static inline int name ## _for_each(struct name *d, \
+				    name ## _iterator_func func, \
+				    void *context) \
+{ \
+	size_t i; \
+	int end = 0; \
+	for (i = d->first_pos; i < d->end_pos && !end; ++i) { \
+		end = func(d, d->data_space + i, context); \
+	} \
+	return end; \
+} \
+\
+struct name ## _allow_semicolon
+
+#endif /* DEQUE_TYPED_H */
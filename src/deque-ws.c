@@ -0,0 +1,223 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-ws.c work-stealing Double-Ended QUEue */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+/*
+   The positions are free running, the slot is (pos & mask), and the
+   number of items is (end - first), compared as a signed difference.
+   The memory orderings follow Le et al., except that where they use a
+   sequentially consistent fence, the position stores and loads around
+   it are sequentially consistent instead, which orders the owner's pop
+   against the thieves' shift in the same way.
+*/
+#include "deque-ws.h"
+#include "eembed.h"
+
+#define deque_ws_diff(end, first) ((ptrdiff_t)((end) - (first)))
+
+static struct deque_ws_buffer *deque_ws_buffer_new(struct eembed_allocator
+						   *ea, size_t len)
+{
+	struct deque_ws_buffer *buf = NULL;
+	size_t header = eembed_align(sizeof(struct deque_ws_buffer));
+	size_t size = header + (len * sizeof(void *));
+
+	if (((size - header) / sizeof(void *)) != len) {
+		return NULL;
+	}
+	buf = (struct deque_ws_buffer *)ea->calloc(ea, 1, size);
+	if (!buf) {
+		return NULL;
+	}
+	buf->mask = len - 1;
+	buf->data_space = (void **)(((unsigned char *)buf) + header);
+	return buf;
+}
+
+static void *deque_ws_get(struct deque_ws_buffer *buf, size_t pos)
+{
+	return __atomic_load_n(&buf->data_space[pos & buf->mask],
+			       __ATOMIC_RELAXED);
+}
+
+static void deque_ws_put(struct deque_ws_buffer *buf, size_t pos, void *data)
+{
+	__atomic_store_n(&buf->data_space[pos & buf->mask], data,
+			 __ATOMIC_RELAXED);
+}
+
+/* owner only: double the buffer, keeping the old for any thieves */
+static struct deque_ws_buffer *deque_ws_grow(struct deque_ws *d,
+					     struct deque_ws_buffer *old,
+					     size_t first, size_t end)
+{
+	struct deque_ws_buffer *buf = NULL;
+	size_t len = (old->mask + 1) * 2;
+	size_t pos;
+
+	if (len < (old->mask + 1)) {
+		return NULL;
+	}
+	buf = deque_ws_buffer_new(d->ea, len);
+	if (!buf) {
+		return NULL;
+	}
+	for (pos = first; pos != end; ++pos) {
+		deque_ws_put(buf, pos, deque_ws_get(old, pos));
+	}
+	buf->retired = old;
+	__atomic_store_n(&d->buffer, buf, __ATOMIC_RELEASE);
+	return buf;
+}
+
+struct deque_ws *deque_ws_push(struct deque_ws *d, void *data)
+{
+	size_t end = __atomic_load_n(&d->end.pos, __ATOMIC_RELAXED);
+	size_t first = __atomic_load_n(&d->first.pos, __ATOMIC_ACQUIRE);
+	struct deque_ws_buffer *buf = d->buffer;
+
+	if (deque_ws_diff(end, first) > (ptrdiff_t)buf->mask) {
+		buf = deque_ws_grow(d, buf, first, end);
+		if (!buf) {
+			return NULL;
+		}
+	}
+	deque_ws_put(buf, end, data);
+	__atomic_store_n(&d->end.pos, end + 1, __ATOMIC_RELEASE);
+	return d;
+}
+
+void *deque_ws_pop(struct deque_ws *d)
+{
+	size_t end = __atomic_load_n(&d->end.pos, __ATOMIC_RELAXED) - 1;
+	struct deque_ws_buffer *buf = d->buffer;
+	size_t first;
+	void *data = NULL;
+
+	__atomic_store_n(&d->end.pos, end, __ATOMIC_SEQ_CST);
+	first = __atomic_load_n(&d->first.pos, __ATOMIC_SEQ_CST);
+
+	if (deque_ws_diff(end, first) < 0) {
+		/* was empty */
+		__atomic_store_n(&d->end.pos, end + 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	data = deque_ws_get(buf, end);
+	if (end == first) {
+		/* the last item, race any thieves for it */
+		if (!__atomic_compare_exchange_n(&d->first.pos, &first,
+						 first + 1, 0,
+						 __ATOMIC_SEQ_CST,
+						 __ATOMIC_RELAXED)) {
+			data = NULL;
+		}
+		__atomic_store_n(&d->end.pos, end + 1, __ATOMIC_RELAXED);
+	}
+	return data;
+}
+
+void *deque_ws_shift(struct deque_ws *d)
+{
+	struct deque_ws_buffer *buf = NULL;
+	size_t first, end;
+	void *data = NULL;
+
+	do {
+		first = __atomic_load_n(&d->first.pos, __ATOMIC_SEQ_CST);
+		end = __atomic_load_n(&d->end.pos, __ATOMIC_SEQ_CST);
+		if (deque_ws_diff(end, first) <= 0) {
+			return NULL;
+		}
+		buf = __atomic_load_n(&d->buffer, __ATOMIC_ACQUIRE);
+		data = deque_ws_get(buf, first);
+		/* on failure, another thread took it: try the next */
+	} while (!__atomic_compare_exchange_n(&d->first.pos, &first,
+					      first + 1, 0, __ATOMIC_SEQ_CST,
+					      __ATOMIC_RELAXED));
+	return data;
+}
+
+size_t deque_ws_size(struct deque_ws *d)
+{
+	size_t first = __atomic_load_n(&d->first.pos, __ATOMIC_ACQUIRE);
+	size_t end = __atomic_load_n(&d->end.pos, __ATOMIC_ACQUIRE);
+
+	if (deque_ws_diff(end, first) < 0) {
+		return 0;
+	}
+	return end - first;
+}
+
+struct deque_ws *deque_ws_init(struct deque_ws *d, size_t data_space_len,
+			       struct eembed_allocator *ea)
+{
+	size_t len = 4;
+
+	if (!ea) {
+		ea = eembed_global_allocator;
+	}
+
+	if (!data_space_len) {
+		data_space_len = Deque_default_len;
+	}
+	while (len < data_space_len && (len * 2) > len) {
+		len *= 2;
+	}
+
+	if (d) {
+		eembed_memset(d, 0x00, sizeof(struct deque_ws));
+	} else {
+		d = (struct deque_ws *)ea->calloc(ea, 1,
+						  sizeof(struct deque_ws));
+		if (!d) {
+			return NULL;
+		}
+		d->deque_needs_free = 1;
+	}
+
+	d->buffer = deque_ws_buffer_new(ea, len);
+	if (!d->buffer) {
+		if (d->deque_needs_free) {
+			ea->free(ea, d);
+		}
+		return NULL;
+	}
+	d->ea = ea;
+
+	return d;
+}
+
+struct deque_ws *deque_ws_new(void)
+{
+	return deque_ws_init(NULL, 0, NULL);
+}
+
+struct deque_ws *deque_ws_new_custom_allocator(struct eembed_allocator *ea)
+{
+	return deque_ws_init(NULL, 0, ea);
+}
+
+void deque_ws_free(struct deque_ws *d)
+{
+	struct eembed_allocator *ea = NULL;
+	struct deque_ws_buffer *buf = NULL;
+
+	if (!d) {
+		return;
+	}
+
+	eembed_assert(d->ea);
+
+	ea = d->ea;
+
+	while (d->buffer) {
+		buf = d->buffer;
+		d->buffer = buf->retired;
+		ea->free(ea, buf);
+	}
+
+	if (d->deque_needs_free) {
+		ea->free(ea, d);
+	}
+}
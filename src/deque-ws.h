@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* deque-ws.h work-stealing Double-Ended QUEue interface */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#ifndef DEQUE_WS_H
+#define DEQUE_WS_H
+
+/*
+   Inspired by: David Chase and Yossi Lev.
+   Dynamic Circular Work-Stealing Deque. SPAA 2005.
+   and: Nhat Minh Le, Antoniu Pop, Albert Cohen, Francesco Zappa Nardelli.
+   Correct and Efficient Work-Stealing for Weak Memory Models. PPoPP 2013.
+*/
+
+#include "deque.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+   A single owner thread may push and pop at the top, as a stack; any
+   thread may shift from the bottom, to steal the oldest item. Nothing
+   is locked. The owner pushes without any atomic read-modify-write, and
+   pops with a compare-and-swap only when taking the very last item.
+*/
+struct deque_ws_buffer {
+	size_t mask;
+	struct deque_ws_buffer *retired;
+	void **data_space;
+};
+
+struct deque_ws {
+	/* shifted by thieves with compare-and-swap */
+	union {
+		size_t pos;
+		unsigned char line[2 * Deque_cache_line];
+	} first;
+	/* written only by the owner */
+	union {
+		size_t pos;
+		unsigned char line[2 * Deque_cache_line];
+	} end;
+
+	/* replaced only by the owner; the buffers which it replaced are
+	   not freed until deque_ws_free, as a thief may still read them */
+	struct deque_ws_buffer *buffer;
+	struct eembed_allocator *ea;
+	int deque_needs_free;
+};
+
+struct deque_ws *deque_ws_init(struct deque_ws *d, size_t data_space_len,
+			       struct eembed_allocator *ea);
+
+struct deque_ws *deque_ws_new(void);
+struct deque_ws *deque_ws_new_custom_allocator(struct eembed_allocator *ea);
+
+/* only once no other thread is using it */
+void deque_ws_free(struct deque_ws *d);
+
+/* owner only: add items to the top */
+struct deque_ws *deque_ws_push(struct deque_ws *d, void *data);
+
+/* owner only: remove the newest item from the top */
+void *deque_ws_pop(struct deque_ws *d);
+
+/* any thread: remove the oldest item from the bottom,
+   returns NULL if it was empty */
+void *deque_ws_shift(struct deque_ws *d);
+
+/* the number of items, which may already have changed */
+size_t deque_ws_size(struct deque_ws *d);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEQUE_WS_H */
@@ -16,43 +16,553 @@
 	eembed_assert(d->data_space != NULL); \
 	eembed_assert(d->ea != NULL); \
 	eembed_assert(d->first_pos <= d->end_pos); \
-	eembed_assert(d->end_pos <= d->data_space_len); \
+	eembed_assert(d->end_pos - d->first_pos <= d->data_space_len); \
+	eembed_assert(d->flags.ring || d->end_pos <= d->data_space_len); \
+	eembed_assert(!d->flags.ring || d->first_pos < d->data_space_len); \
 } while (0)
 
-void *deque_peek_top(struct deque *d, size_t index)
+/* the stats are only kept if built with Deque_stats, see configure.ac */
+#ifndef Deque_stats
+#define Deque_stats 0
+#endif
+
+#if Deque_stats
+#define deque_stats_add(d, field, n) do { \
+	if ((d)->stats) { \
+		(d)->stats->field += (n); \
+	} \
+} while (0)
+
+static void deque_stats_peak(struct deque *d)
 {
-	size_t i = 0;
+	size_t used = d->end_pos - d->first_pos;
 
-	deque_assert(d);
+	if (!d->stats) {
+		return;
+	}
+	if (used > d->stats->peak_size) {
+		d->stats->peak_size = used;
+	}
+	if (d->data_space_len > d->stats->peak_capacity) {
+		d->stats->peak_capacity = d->data_space_len;
+	}
+}
+#else
+#define deque_stats_add(d, field, n) do { (void)(n); } while (0)
+#define deque_stats_peak(d) do { } while (0)
+#endif
 
-	if (d->first_pos == d->end_pos) {
+/* In ring mode first_pos is always inside of data_space, but end_pos
+   may run past the end of data_space, and wraps around to the start.
+   In linear mode end_pos is never past the end, thus the slot is pos. */
+#define deque_slot(d, pos) \
+	(((pos) < (d)->data_space_len) ? (pos) : ((pos) - (d)->data_space_len))
+
+/* the slots which follow a struct deque allocated by deque_init, until
+   the data_space grows out of line */
+#define deque_inline_space(d) ((void **)(((struct deque *)(d)) + 1))
+
+/* the default length of that inline data_space: Deque_default_len less
+   the slots the struct takes, but not less than 4, should a small
+   Deque_default_len be defined */
+#define Deque_struct_slots (sizeof(struct deque) / sizeof(void *))
+#define Deque_default_inline_len \
+	((Deque_default_len > (Deque_struct_slots + 4)) \
+	 ? (Deque_default_len - Deque_struct_slots) : 4)
+
+/* copy n items, in order, from logical position pos out to dest */
+static void deque_copy_out(struct deque *d, size_t pos, void **dest, size_t n)
+{
+	size_t i = deque_slot(d, pos);
+	size_t span = d->data_space_len - i;
+
+	if (span > n) {
+		span = n;
+	}
+	eembed_memcpy(dest, &d->data_space[i], sizeof(void *) * span);
+	if (n > span) {
+		/* wrapped ring, the rest is at the start of data_space */
+		eembed_memcpy(dest + span, d->data_space,
+			      sizeof(void *) * (n - span));
+	}
+}
+
+/* copy n items, in order, from src in to logical position pos */
+static void deque_copy_in(struct deque *d, size_t pos, void **src, size_t n)
+{
+	size_t i = deque_slot(d, pos);
+	size_t span = d->data_space_len - i;
+
+	if (span > n) {
+		span = n;
+	}
+	eembed_memcpy(&d->data_space[i], src, sizeof(void *) * span);
+	if (n > span) {
+		eembed_memcpy(d->data_space, src + span,
+			      sizeof(void *) * (n - span));
+	}
+}
+
+/* the most slots skipped must fit in the 8 bits of flags.align_pad */
+typedef char deque_align_pad_fits[((Deque_cache_line / sizeof(void *))
+				   <= 256) ? 1 : -1];
+
+/* allocate len slots, zeroed if zero; if aligned, extra slots are
+   allocated, and *pad of them are skipped to reach a cache line */
+static void **deque_space_alloc(struct eembed_allocator *ea, size_t len,
+				int aligned, int zero, size_t *pad)
+{
+	size_t extra = aligned ? (Deque_cache_line / sizeof(void *)) - 1 : 0;
+	size_t offset = 0;
+	void **space = NULL;
+
+	*pad = 0;
+	if (len > (SIZE_MAX / sizeof(void *)) - extra) {
 		return NULL;
 	}
-	if (index >= d->end_pos) {
+	if (zero) {
+		space = (void **)ea->calloc(ea, len + extra, sizeof(void *));
+	} else {
+		space = (void **)ea->malloc(ea, sizeof(void *) * (len + extra));
+	}
+	if (space && aligned) {
+		offset = ((uintptr_t)space) % Deque_cache_line;
+		if (offset) {
+			*pad = (Deque_cache_line - offset) / sizeof(void *);
+		}
+	}
+	return space ? space + *pad : NULL;
+}
+
+static void deque_space_free(struct deque *d)
+{
+	d->ea->free(d->ea, d->data_space - d->flags.align_pad);
+}
+
+/* allocate a zeroed struct; if aligned, on a cache line, with the
+   allocated pointer kept in the slot just before it */
+static struct deque *deque_struct_alloc(struct eembed_allocator *ea,
+					int aligned)
+{
+	size_t offset = 0;
+	unsigned char *raw = NULL;
+	struct deque *d = NULL;
+
+	if (!aligned) {
+		return (struct deque *)ea->calloc(ea, 1, sizeof(struct deque));
+	}
+	raw = (unsigned char *)ea->calloc(ea, 1, sizeof(void *)
+					  + Deque_cache_line
+					  + sizeof(struct deque));
+	if (!raw) {
 		return NULL;
 	}
-	i = d->end_pos - (index + 1);
-	if (i < d->first_pos) {
+	offset = ((uintptr_t)(raw + sizeof(void *))) % Deque_cache_line;
+	d = (struct deque *)(raw + sizeof(void *)
+			     + (offset ? Deque_cache_line - offset : 0));
+	((void **)d)[-1] = raw;
+	return d;
+}
+
+static void deque_struct_free(struct eembed_allocator *ea, struct deque *d,
+			      int aligned)
+{
+	ea->free(ea, aligned ? ((void **)d)[-1] : (void *)d);
+}
+
+/* NULL-out n vacated slots, starting at logical position pos */
+static void deque_scrub(struct deque *d, size_t pos, size_t n)
+{
+	size_t i = deque_slot(d, pos);
+	size_t span = d->data_space_len - i;
+
+	if (d->flags.no_scrub) {
+		return;
+	}
+	if (span > n) {
+		span = n;
+	}
+	eembed_memset(&d->data_space[i], 0x00, sizeof(void *) * span);
+	if (n > span) {
+		eembed_memset(d->data_space, 0x00, sizeof(void *) * (n - span));
+	}
+}
+
+/* move n items from logical position "from" to "to", which may overlap;
+   in a ring, either run of slots may wrap around the end of data_space */
+static void deque_move(struct deque *d, size_t to, size_t from, size_t n)
+{
+	size_t i, j, span;
+
+	if (to < from) {
+		while (n) {
+			i = deque_slot(d, to);
+			j = deque_slot(d, from);
+			span = d->data_space_len - ((i > j) ? i : j);
+			if (span > n) {
+				span = n;
+			}
+			eembed_memmove(&d->data_space[i], &d->data_space[j],
+				       sizeof(void *) * span);
+			to += span;
+			from += span;
+			n -= span;
+		}
+		return;
+	}
+	/* moving toward the end, thus copy the last items first */
+	while (n) {
+		i = deque_slot(d, to + n - 1);
+		j = deque_slot(d, from + n - 1);
+		span = 1 + ((i < j) ? i : j);
+		if (span > n) {
+			span = n;
+		}
+		eembed_memmove(&d->data_space[i + 1 - span],
+			       &d->data_space[j + 1 - span],
+			       sizeof(void *) * span);
+		n -= span;
+	}
+}
+
+/* zero memory which is about to be freed, or handed back to the caller,
+   thus a memset which the compiler may not remove as a dead store */
+static void deque_secure_zero(void *p, size_t size)
+{
+#if defined(__GNUC__)
+	eembed_memset(p, 0x00, size);
+	__asm__ __volatile__("" : : "r"(p) : "memory");
+#else
+	volatile unsigned char *v = (volatile unsigned char *)p;
+	while (size--) {
+		*v++ = 0x00;
+	}
+#endif
+}
+
+/* after the data_space has been resized, with items_moved copied */
+static void deque_resized(struct deque *d, size_t old_space_len,
+			  size_t items_moved)
+{
+	deque_stats_add(d, bytes_moved, (uint64_t)items_moved * sizeof(void *));
+	if (d->data_space_len < old_space_len) {
+		deque_stats_add(d, shrinks, 1);
+		return;
+	}
+	deque_stats_add(d, grows, 1);
+	deque_stats_peak(d);
+	if (d->policy && d->policy->on_grow) {
+		d->policy->on_grow(d, old_space_len, d->data_space_len,
+				   d->policy->hook_context);
+	}
+}
+
+/* move the items within the data_space, to start at new_first_pos */
+static void deque_recenter(struct deque *d, size_t new_first_pos)
+{
+	size_t used = d->end_pos - d->first_pos;
+
+	eembed_memmove(&d->data_space[new_first_pos],
+		       &d->data_space[d->first_pos], sizeof(void *) * used);
+	d->first_pos = new_first_pos;
+	d->end_pos = new_first_pos + used;
+
+	deque_stats_add(d, recenters, 1);
+	deque_stats_add(d, bytes_moved, (uint64_t)used * sizeof(void *));
+	if (d->policy && d->policy->on_recenter) {
+		d->policy->on_recenter(d, used, d->policy->hook_context);
+	}
+}
+
+/* resize an owned data_space with ea->realloc, which may be able to
+   extend the block in place; the items are then moved within it.
+   In a ring, new_first_pos is ignored, the fewest items are moved. */
+static struct deque *deque_realloc(struct deque *d, size_t new_space_len,
+				   size_t new_first_pos)
+{
+	struct eembed_allocator *ea = d->ea;
+	size_t old_space_len = d->data_space_len;
+	size_t used = d->end_pos - d->first_pos;
+	size_t size = sizeof(void *) * new_space_len;
+	size_t tail = 0;
+	size_t wrapped = 0;
+	size_t moved = 0;
+	void **new_space = NULL;
+
+	if (new_space_len < old_space_len) {
+		/* move the items in to the part which remains, then shrink */
+		eembed_assert(d->end_pos <= old_space_len);
+		eembed_memmove(&d->data_space[new_first_pos],
+			       &d->data_space[d->first_pos],
+			       sizeof(void *) * used);
+		d->first_pos = new_first_pos;
+		d->end_pos = new_first_pos + used;
+		new_space = (void **)ea->realloc(ea, d->data_space, size);
+		if (!new_space) {
+			/* still valid, simply not any smaller */
+			return NULL;
+		}
+		d->data_space = new_space;
+		d->data_space_len = new_space_len;
+		deque_resized(d, old_space_len, used);
+		return d;
+	}
+
+	new_space = (void **)ea->realloc(ea, d->data_space, size);
+	if (!new_space) {
 		return NULL;
 	}
+	d->data_space = new_space;
+	d->data_space_len = new_space_len;
+
+	if (d->end_pos > old_space_len) {
+		/* a wrapped ring: the first items are at the old end, and
+		   the rest are at the start of data_space */
+		tail = old_space_len - d->first_pos;
+		wrapped = used - tail;
+		if (wrapped <= tail
+		    && wrapped <= (new_space_len - old_space_len)) {
+			/* unwrap, the positions remain the same */
+			eembed_memcpy(&new_space[old_space_len], new_space,
+				      sizeof(void *) * wrapped);
+			moved = wrapped;
+		} else {
+			/* move the first items to the new end */
+			eembed_memmove(&new_space[new_space_len - tail],
+				       &new_space[d->first_pos],
+				       sizeof(void *) * tail);
+			d->first_pos = new_space_len - tail;
+			d->end_pos = d->first_pos + used;
+			moved = tail;
+		}
+	} else if (!d->flags.ring) {
+		eembed_memmove(&new_space[new_first_pos],
+			       &new_space[d->first_pos], sizeof(void *) * used);
+		d->first_pos = new_first_pos;
+		d->end_pos = new_first_pos + used;
+		moved = used;
+	}
 
-	return d->data_space[i];
+	deque_resized(d, old_space_len, moved);
+	return d;
 }
 
-void *deque_peek_bottom(struct deque *d, size_t index)
+/* copy the items, in order, to a new space of new_space_len */
+static struct deque *deque_resize(struct deque *d, size_t new_space_len,
+				  size_t new_first_pos)
+{
+	struct eembed_allocator *ea = d->ea;
+	size_t old_space_len = d->data_space_len;
+	size_t used = d->end_pos - d->first_pos;
+	size_t pad = 0;
+	void **new_space = NULL;
+
+	eembed_assert(new_first_pos + used <= new_space_len);
+
+	if (ea->realloc && d->flags.data_space_needs_free
+	    && !d->flags.secure_scrub && !d->flags.aligned
+	    && (new_space_len > d->data_space_len
+		|| d->end_pos <= d->data_space_len)) {
+		return deque_realloc(d, new_space_len, new_first_pos);
+	}
+
+	new_space = deque_space_alloc(ea, new_space_len, d->flags.aligned, 0,
+				      &pad);
+	if (!new_space) {
+		return NULL;
+	}
+
+	deque_copy_out(d, d->first_pos, &new_space[new_first_pos], used);
+
+	if (d->flags.secure_scrub) {
+		deque_secure_zero(d->data_space,
+				  sizeof(void *) * d->data_space_len);
+	}
+	if (d->flags.data_space_needs_free) {
+		deque_space_free(d);
+	}
+	d->data_space = new_space;
+	d->data_space_len = new_space_len;
+	d->flags.data_space_needs_free = 1;
+	d->flags.align_pad = (uint8_t)pad;
+	d->first_pos = new_first_pos;
+	d->end_pos = new_first_pos + used;
+	deque_resized(d, old_space_len, used);
+
+	return d;
+}
+
+/* percent of n, without overflowing for large n */
+static size_t deque_percent(size_t n, size_t percent)
+{
+	return ((n / 100) * percent) + (((n % 100) * percent) / 100);
+}
+
+/* choose the new data_space length, at least min_len, or 0 if too big */
+static size_t deque_grow_len(struct deque *d, size_t min_len, int unshifting)
+{
+	const struct deque_policy *policy = d->policy;
+	size_t max_len = ((size_t)-1) / sizeof(void *);
+	size_t old_space_len = d->data_space_len;
+	size_t new_space_len = 0;
+	size_t step = old_space_len;
+
+	if (policy && policy->grow_func) {
+		new_space_len = policy->grow_func(d, min_len, unshifting,
+						  policy->grow_context);
+	} else {
+		if (policy && policy->grow_percent > 100) {
+			step = deque_percent(old_space_len,
+					     policy->grow_percent - 100);
+		}
+		if (policy && policy->grow_max_step
+		    && step > policy->grow_max_step) {
+			step = policy->grow_max_step;
+		}
+		if (!step) {
+			step = 1;
+		}
+		new_space_len = old_space_len + step;
+		if (new_space_len < old_space_len) {
+			return 0;
+		}
+	}
+
+	if (new_space_len < min_len) {
+		new_space_len = min_len;
+	}
+	if (new_space_len > max_len) {
+		return 0;
+	}
+	return new_space_len;
+}
+
+/* grow the data_space, leaving at least front and back free slots */
+static struct deque *deque_grow(struct deque *d, size_t front, size_t back,
+				int unshifting)
+{
+	const struct deque_policy *policy = d->policy;
+	size_t used = d->end_pos - d->first_pos;
+	size_t need = used + front + back;
+	size_t new_space_len = 0;
+	size_t slack = 0;
+	size_t extra = 0;
+
+	if (need < used) {
+		return NULL;
+	}
+
+	new_space_len = deque_grow_len(d, need, unshifting);
+	if (!new_space_len) {
+		return NULL;
+	}
+	if (d->flags.ring) {
+		return deque_resize(d, new_space_len, 0);
+	}
+
+	/* split the spare slots between the front and the back */
+	slack = new_space_len - need;
+	if (policy && policy->front_percent) {
+		extra = deque_percent(slack, policy->front_percent > 100
+				      ? 100 : policy->front_percent);
+	} else if (unshifting) {
+		/* the new space to the front for unshifting */
+		extra = slack;
+	} else {
+		/* allow some free space for unshifting */
+		extra = slack / 2;
+	}
+	return deque_resize(d, new_space_len, front + extra);
+}
+
+/* ensure free slots before and after the items, growing at most once */
+static struct deque *deque_make_room(struct deque *d, size_t front,
+				     size_t back)
+{
+	size_t used = d->end_pos - d->first_pos;
+	size_t need = used + front + back;
+	size_t new_first_pos = 0;
+
+	if (need < used) {
+		/* overflow */
+		return NULL;
+	}
+
+	if (d->flags.ring) {
+		/* in a ring, all of the free space is at both ends */
+		if (need <= d->data_space_len) {
+			return d;
+		}
+	} else if (d->first_pos >= front
+		   && (d->data_space_len - d->end_pos) >= back) {
+		return d;
+	} else if (need <= d->data_space_len) {
+		/* enough space, but not at the right ends: re-center */
+		new_first_pos = front + ((d->data_space_len - need) / 2);
+		deque_recenter(d, new_first_pos);
+		return d;
+	}
+
+	return deque_grow(d, front, back, (front && !back));
+}
+
+/* halve an owned data_space once it is mostly empty, if so configured */
+static void deque_auto_shrink(struct deque *d)
+{
+	size_t divisor = d->policy->shrink_divisor;
+	size_t min_len = d->policy->shrink_min_len;
+	size_t used = d->end_pos - d->first_pos;
+	size_t new_space_len = d->data_space_len / 2;
+	size_t new_first_pos = 0;
+
+	if (!divisor || !d->flags.data_space_needs_free) {
+		return;
+	}
+	if (divisor < 4) {
+		divisor = 4;
+	}
+	if (used >= (d->data_space_len / divisor)) {
+		return;
+	}
+	if (!min_len) {
+		min_len = Deque_default_len;
+	}
+	if (new_space_len < min_len) {
+		return;
+	}
+	if (!d->flags.ring) {
+		new_first_pos = (new_space_len - used) / 2;
+	}
+	/* if the allocation fails, simply keep the larger space */
+	deque_resize(d, new_space_len, new_first_pos);
+}
+
+void *deque_peek_top(struct deque *d, size_t index)
 {
 	size_t i = 0;
 
 	deque_assert(d);
 
-	if (d->first_pos == d->end_pos) {
+	if (index >= (d->end_pos - d->first_pos)) {
 		return NULL;
 	}
-	i = index + d->first_pos;
-	if (i >= d->end_pos) {
+	i = d->end_pos - (index + 1);
+
+	return d->data_space[deque_slot(d, i)];
+}
+
+void *deque_peek_bottom(struct deque *d, size_t index)
+{
+	size_t i = 0;
+
+	deque_assert(d);
+
+	if (index >= (d->end_pos - d->first_pos)) {
 		return NULL;
 	}
-	return d->data_space[i];
+	i = index + d->first_pos;
+
+	return d->data_space[deque_slot(d, i)];
 }
 
 size_t deque_size(struct deque *d)
@@ -62,56 +572,54 @@ size_t deque_size(struct deque *d)
 	return d->end_pos - d->first_pos;
 }
 
+static struct deque *deque_ring_push(struct deque *d, void *user_data)
+{
+	size_t used = d->end_pos - d->first_pos;
+
+	if (used == d->data_space_len) {
+		if (!deque_grow(d, 0, 1, 0)) {
+			return NULL;
+		}
+	}
+	d->data_space[deque_slot(d, d->end_pos)] = user_data;
+	++d->end_pos;
+	deque_stats_add(d, pushes, 1);
+	deque_stats_peak(d);
+	return d;
+}
+
 struct deque *deque_push(struct deque *d, void *user_data)
 {
 	deque_assert(d);
 
+	if (d->flags.ring) {
+		return deque_ring_push(d, user_data);
+	}
+
 	if (d->end_pos == d->data_space_len) {
 		/* no space to append at end */
 		if (d->first_pos > 1) {
 			/* free space at beginning, shift content that way */
 			/* use half of the free space */
-			size_t new_first_pos = d->first_pos / 2;
-			size_t pos_shift = d->first_pos - new_first_pos;
-			size_t used = d->end_pos - d->first_pos;
-			eembed_assert(pos_shift > 0);
-			eembed_memmove(&d->data_space[new_first_pos],
-				       &d->data_space[d->first_pos],
-				       sizeof(void *) * used);
-			d->first_pos -= pos_shift;
-			d->end_pos -= pos_shift;
+			deque_recenter(d, d->first_pos / 2);
 		} else {
-			/* no free space, double the amount */
-			size_t old_space_len = d->data_space_len;
-			size_t new_space_len = old_space_len * 2;
-			size_t size = sizeof(void *) * new_space_len;
-			/* allow some free space for unshifting */
-			size_t pos_shift =
-			    Deque_default_unshift_space(new_space_len);
-			void **old_space = d->data_space;
-			struct eembed_allocator *ea = d->ea;
-			size_t old_size = sizeof(void *) * old_space_len;
-			void **new_space = (void **)ea->malloc(ea, size);
-			if (!new_space) {
+			/* no free space, grow */
+			if (!deque_grow(d, 0, 1, 0)) {
 				return NULL;
 			}
-			eembed_memmove(&new_space[pos_shift], old_space,
-				       old_size);
-			ea->free(ea, old_space);
-			d->data_space = new_space;
-			d->data_space_len = new_space_len;
-			d->first_pos += pos_shift;
-			d->end_pos += pos_shift;
 		}
 	}
 	eembed_assert(d->end_pos < d->data_space_len);
 	d->data_space[d->end_pos++] = user_data;
+	deque_stats_add(d, pushes, 1);
+	deque_stats_peak(d);
 	return d;
 }
 
 void *deque_pop(struct deque *d)
 {
 	void *user_data = NULL;
+	size_t i = 0;
 
 	deque_assert(d);
 
@@ -121,18 +629,51 @@ void *deque_pop(struct deque *d)
 
 	eembed_assert(d->end_pos > 0);
 
-	user_data = d->data_space[--d->end_pos];
-	d->data_space[d->end_pos] = NULL;
+	--d->end_pos;
+	i = deque_slot(d, d->end_pos);
+	user_data = d->data_space[i];
+	if (!d->flags.no_scrub) {
+		d->data_space[i] = NULL;
+	}
 
 	eembed_assert(d->first_pos <= d->end_pos);
+	deque_stats_add(d, pops, 1);
+
+	if (d->policy) {
+		deque_auto_shrink(d);
+	}
 
 	return user_data;
 }
 
+static struct deque *deque_ring_unshift(struct deque *d, void *user_data)
+{
+	size_t used = d->end_pos - d->first_pos;
+
+	if (used == d->data_space_len) {
+		if (!deque_grow(d, 1, 0, 1)) {
+			return NULL;
+		}
+	}
+	if (d->first_pos == 0) {
+		/* wrap around to the end of data_space */
+		d->first_pos += d->data_space_len;
+		d->end_pos += d->data_space_len;
+	}
+	d->data_space[--d->first_pos] = user_data;
+	deque_stats_add(d, unshifts, 1);
+	deque_stats_peak(d);
+	return d;
+}
+
 struct deque *deque_unshift(struct deque *d, void *user_data)
 {
 	deque_assert(d);
 
+	if (d->flags.ring) {
+		return deque_ring_unshift(d, user_data);
+	}
+
 	if (d->first_pos == d->end_pos) {
 		/* unshifting onto an empty deque */
 		/* best to make extra room, put first item in the middle */
@@ -144,34 +685,12 @@ struct deque *deque_unshift(struct deque *d, void *user_data)
 		if (d->end_pos < d->data_space_len) {
 			/* but room at the end, use half of that */
 			size_t avail = d->data_space_len - d->end_pos;
-			size_t pos_shift = 1 + (avail / 2);
-			size_t size = sizeof(void *) * d->end_pos;
-			eembed_memmove(&d->data_space[pos_shift], d->data_space,
-				       size);
-			d->first_pos += pos_shift;
-			d->end_pos += pos_shift;
+			deque_recenter(d, 1 + (avail / 2));
 		} else {
-			/* no room at all, double space */
-			size_t old_space_len = d->data_space_len;
-			size_t new_space_len = old_space_len * 2;
-			size_t size = sizeof(void *) * new_space_len;
-			size_t old_size = sizeof(void *) * old_space_len;
-			/* give half the new space to front for unshifting */
-			size_t pos_shift = new_space_len / 2;
-			void **old_space = d->data_space;
-			struct eembed_allocator *ea = d->ea;
-			void **new_space = (void **)ea->malloc(ea, size);
-			if (!new_space) {
+			/* no room at all, grow */
+			if (!deque_grow(d, 1, 0, 1)) {
 				return NULL;
 			}
-			eembed_memmove(&new_space[pos_shift], old_space,
-				       old_size);
-
-			ea->free(ea, old_space);
-			d->data_space = new_space;
-			d->data_space_len = new_space_len;
-			d->first_pos += pos_shift;
-			d->end_pos += pos_shift;
 		}
 	}
 	eembed_assert(d->first_pos > 0);
@@ -179,6 +698,8 @@ struct deque *deque_unshift(struct deque *d, void *user_data)
 	d->data_space[--d->first_pos] = user_data;
 
 	eembed_assert(d->first_pos <= d->end_pos);
+	deque_stats_add(d, unshifts, 1);
+	deque_stats_peak(d);
 
 	return d;
 }
@@ -196,23 +717,331 @@ void *deque_shift(struct deque *d)
 	eembed_assert(d->first_pos < d->data_space_len);
 
 	user_data = d->data_space[d->first_pos];
-	d->data_space[d->first_pos] = NULL;
+	if (!d->flags.no_scrub) {
+		d->data_space[d->first_pos] = NULL;
+	}
 	++d->first_pos;
 
-	if (d->first_pos == d->end_pos) {
+	if (d->flags.ring) {
+		if (d->first_pos == d->data_space_len) {
+			/* wrap around to the start of data_space */
+			d->first_pos -= d->data_space_len;
+			d->end_pos -= d->data_space_len;
+		}
+	} else if (d->first_pos == d->end_pos) {
 		size_t pos = Deque_default_unshift_space(d->data_space_len);
 		d->first_pos = pos;
 		d->end_pos = pos;
 	}
 
 	eembed_assert(d->first_pos <= d->end_pos);
+	deque_stats_add(d, shifts, 1);
+
+	if (d->policy) {
+		deque_auto_shrink(d);
+	}
 
 	return user_data;
 }
 
+/* after items were removed from the front, the back, or the middle */
+static void deque_removed(struct deque *d)
+{
+	if (d->flags.ring) {
+		if (d->first_pos >= d->data_space_len) {
+			d->first_pos -= d->data_space_len;
+			d->end_pos -= d->data_space_len;
+		}
+	} else if (d->first_pos == d->end_pos) {
+		size_t pos = Deque_default_unshift_space(d->data_space_len);
+		d->first_pos = pos;
+		d->end_pos = pos;
+	}
+
+	if (d->policy) {
+		deque_auto_shrink(d);
+	}
+}
+
+struct deque *deque_push_n(struct deque *d, void **items, size_t n)
+{
+	deque_assert(d);
+
+	if (!deque_make_room(d, 0, n)) {
+		return NULL;
+	}
+
+	deque_copy_in(d, d->end_pos, items, n);
+	d->end_pos += n;
+	deque_stats_add(d, pushes, n);
+	deque_stats_peak(d);
+
+	return d;
+}
+
+size_t deque_pop_n(struct deque *d, void **out, size_t n)
+{
+	size_t used = 0;
+	size_t i = 0;
+
+	deque_assert(d);
+
+	used = d->end_pos - d->first_pos;
+	if (n > used) {
+		n = used;
+	}
+
+	/* out[0] is the top, as it would be from repeated deque_pop */
+	for (i = 0; i < n; ++i) {
+		out[i] = d->data_space[deque_slot(d, d->end_pos - (i + 1))];
+	}
+	d->end_pos -= n;
+	deque_scrub(d, d->end_pos, n);
+	deque_stats_add(d, pops, n);
+
+	if (d->policy) {
+		deque_auto_shrink(d);
+	}
+
+	return n;
+}
+
+struct deque *deque_unshift_n(struct deque *d, void **items, size_t n)
+{
+	size_t i = 0;
+
+	deque_assert(d);
+
+	if (!deque_make_room(d, n, 0)) {
+		return NULL;
+	}
+
+	if (d->flags.ring && d->first_pos < n) {
+		/* wrap around to the end of data_space */
+		d->first_pos += d->data_space_len;
+		d->end_pos += d->data_space_len;
+	}
+
+	/* items[n-1] ends up first, as from repeated deque_unshift */
+	for (i = 0; i < n; ++i) {
+		--d->first_pos;
+		d->data_space[deque_slot(d, d->first_pos)] = items[i];
+	}
+	deque_stats_add(d, unshifts, n);
+	deque_stats_peak(d);
+
+	return d;
+}
+
+size_t deque_shift_n(struct deque *d, void **out, size_t n)
+{
+	size_t used = 0;
+
+	deque_assert(d);
+
+	used = d->end_pos - d->first_pos;
+	if (n > used) {
+		n = used;
+	}
+
+	deque_copy_out(d, d->first_pos, out, n);
+	deque_scrub(d, d->first_pos, n);
+	d->first_pos += n;
+	deque_stats_add(d, shifts, n);
+	deque_removed(d);
+
+	return n;
+}
+
+struct deque *deque_insert_at(struct deque *d, size_t index, void *user_data)
+{
+	size_t used = 0;
+
+	deque_assert(d);
+
+	used = d->end_pos - d->first_pos;
+	if (index > used) {
+		return NULL;
+	}
+
+	if (index < (used - index)) {
+		/* fewer items before, move those toward the front */
+		if (!deque_make_room(d, 1, 0)) {
+			return NULL;
+		}
+		if (d->flags.ring && d->first_pos == 0) {
+			/* wrap around to the end of data_space */
+			d->first_pos += d->data_space_len;
+			d->end_pos += d->data_space_len;
+		}
+		deque_move(d, d->first_pos - 1, d->first_pos, index);
+		--d->first_pos;
+	} else {
+		if (!deque_make_room(d, 0, 1)) {
+			return NULL;
+		}
+		deque_move(d, d->first_pos + index + 1, d->first_pos + index,
+			   used - index);
+		++d->end_pos;
+	}
+	d->data_space[deque_slot(d, d->first_pos + index)] = user_data;
+	deque_stats_peak(d);
+
+	return d;
+}
+
+void *deque_erase_at(struct deque *d, size_t index)
+{
+	void *user_data = NULL;
+
+	deque_assert(d);
+
+	if (index >= (d->end_pos - d->first_pos)) {
+		return NULL;
+	}
+	user_data = d->data_space[deque_slot(d, d->first_pos + index)];
+	deque_erase_range(d, index, index + 1);
+
+	return user_data;
+}
+
+size_t deque_erase_range(struct deque *d, size_t from, size_t to)
+{
+	size_t used = 0;
+	size_t n = 0;
+
+	deque_assert(d);
+
+	used = d->end_pos - d->first_pos;
+	if (to > used) {
+		to = used;
+	}
+	if (from >= to) {
+		return 0;
+	}
+	n = to - from;
+
+	if (from < (used - to)) {
+		/* fewer items before, move those toward the back */
+		deque_move(d, d->first_pos + n, d->first_pos, from);
+		deque_scrub(d, d->first_pos, n);
+		d->first_pos += n;
+	} else {
+		deque_move(d, d->first_pos + from, d->first_pos + to,
+			   used - to);
+		d->end_pos -= n;
+		deque_scrub(d, d->end_pos, n);
+	}
+	deque_removed(d);
+
+	return n;
+}
+
+size_t deque_remove_if(struct deque *d, deque_iterator_func pred,
+		       void *context)
+{
+	size_t used = 0;
+	size_t kept = 0;
+	size_t i = 0;
+	size_t j = 0;
+	void *each = NULL;
+
+	deque_assert(d);
+
+	used = d->end_pos - d->first_pos;
+	for (i = 0; i < used; ++i) {
+		each = d->data_space[deque_slot(d, d->first_pos + i)];
+		if (pred(d, each, context)) {
+			continue;
+		}
+		if (kept != i) {
+			j = deque_slot(d, d->first_pos + kept);
+			d->data_space[j] = each;
+		}
+		++kept;
+	}
+	if (kept == used) {
+		return 0;
+	}
+	d->end_pos = d->first_pos + kept;
+	deque_scrub(d, d->end_pos, used - kept);
+	deque_removed(d);
+
+	return used - kept;
+}
+
+struct deque *deque_shrink_to_fit(struct deque *d)
+{
+	size_t used = 0;
+
+	deque_assert(d);
+
+	used = d->end_pos - d->first_pos;
+	if (!used) {
+		/* keep at least one slot */
+		used = 1;
+	}
+	if (used >= d->data_space_len || !d->flags.data_space_needs_free) {
+		return d;
+	}
+
+	return deque_resize(d, used, 0);
+}
+
+struct deque *deque_reserve(struct deque *d, size_t front_slots,
+			    size_t back_slots)
+{
+	deque_assert(d);
+
+	return deque_make_room(d, front_slots, back_slots);
+}
+
+size_t deque_capacity(struct deque *d)
+{
+	deque_assert(d);
+
+	return d->data_space_len;
+}
+
+void deque_set_policy(struct deque *d, const struct deque_policy *policy)
+{
+	deque_assert(d);
+
+	d->policy = policy;
+}
+
+struct deque *deque_set_stats(struct deque *d, struct deque_stats *stats)
+{
+	deque_assert(d);
+
+#if Deque_stats
+	d->stats = stats;
+	deque_stats_peak(d);
+	return d;
+#else
+	(void)stats;
+	return NULL;
+#endif
+}
+
+int deque_stats(struct deque *d, struct deque_stats *out)
+{
+	deque_assert(d);
+
+	eembed_memset(out, 0x00, sizeof(struct deque_stats));
+	if (!d->stats) {
+		return -1;
+	}
+	eembed_memcpy(out, d->stats, sizeof(struct deque_stats));
+	return 0;
+}
+
 void deque_clear(struct deque *d)
 {
 	deque_assert(d);
+	if (d->flags.secure_scrub) {
+		deque_scrub(d, d->first_pos, d->end_pos - d->first_pos);
+	}
 	d->first_pos = Deque_default_unshift_space(d->data_space_len);
 	d->end_pos = d->first_pos;
 }
@@ -225,14 +1054,119 @@ int deque_for_each(struct deque *d, deque_iterator_func pfunc, void *context)
 
 	end = 0;
 	for (i = d->first_pos; i < d->end_pos && !end; ++i) {
-		end = pfunc(d, d->data_space[i], context);
+		end = pfunc(d, d->data_space[deque_slot(d, i)], context);
+	}
+	return end;
+}
+
+int deque_for_each_reverse(struct deque *d, deque_iterator_func pfunc,
+			   void *context)
+{
+	size_t i, end;
+
+	deque_assert(d);
+
+	end = 0;
+	for (i = d->end_pos; i > d->first_pos && !end; --i) {
+		end = pfunc(d, d->data_space[deque_slot(d, i - 1)], context);
+	}
+	return end;
+}
+
+int deque_for_each_range(struct deque *d, size_t from, size_t to,
+			 deque_iterator_func pfunc, void *context)
+{
+	size_t i, end, used;
+
+	deque_assert(d);
+
+	used = d->end_pos - d->first_pos;
+	if (to > used) {
+		to = used;
+	}
+
+	end = 0;
+	for (i = from; i < to && !end; ++i) {
+		end = pfunc(d, d->data_space[deque_slot(d, d->first_pos + i)],
+			    context);
 	}
 	return end;
 }
 
+int deque_as_spans(struct deque *d, void ***a, size_t *a_len, void ***b,
+		   size_t *b_len)
+{
+	size_t used, span;
+
+	deque_assert(d);
+
+	used = d->end_pos - d->first_pos;
+	span = d->data_space_len - d->first_pos;
+
+	*a = used ? &d->data_space[d->first_pos] : NULL;
+	*a_len = used;
+	*b = NULL;
+	*b_len = 0;
+	if (used > span) {
+		/* a wrapped ring, the rest is at the start of data_space */
+		*a_len = span;
+		*b = d->data_space;
+		*b_len = used - span;
+		return 2;
+	}
+	return used ? 1 : 0;
+}
+
+struct deque_cursor *deque_cursor_init(struct deque_cursor *c,
+				       struct deque *d, size_t index)
+{
+	deque_as_spans(d, &c->a, &c->a_len, &c->b, &c->b_len);
+	if (index > c->a_len + c->b_len) {
+		index = c->a_len + c->b_len;
+	}
+	c->index = index;
+	return c;
+}
+
+void **deque_cursor_next(struct deque_cursor *c)
+{
+	if (c->index < c->a_len) {
+		return &c->a[c->index++];
+	}
+	if (c->index < c->a_len + c->b_len) {
+		return &c->b[(c->index++) - c->a_len];
+	}
+	return NULL;
+}
+
+void **deque_cursor_prev(struct deque_cursor *c)
+{
+	if (!c->index) {
+		return NULL;
+	}
+	--c->index;
+	if (c->index < c->a_len) {
+		return &c->a[c->index];
+	}
+	return &c->b[c->index - c->a_len];
+}
+
 struct deque *deque_init(struct deque *d, void **data_space,
 			 size_t data_space_len, struct eembed_allocator *ea)
 {
+	return deque_init_options(d, data_space, data_space_len, ea, 0);
+}
+
+struct deque *deque_init_options(struct deque *d, void **data_space,
+				 size_t data_space_len,
+				 struct eembed_allocator *ea, unsigned options)
+{
+	int secure_scrub = (options & Deque_option_secure_scrub) ? 1 : 0;
+	int no_scrub = (options & Deque_option_no_scrub) ? !secure_scrub : 0;
+	int scrub = !no_scrub;
+	int aligned = (options & Deque_option_aligned) ? 1 : 0;
+	size_t size = 0;
+	size_t pad = 0;
 
 	if (!ea) {
 		ea = eembed_global_allocator;
@@ -240,8 +1174,39 @@ struct deque *deque_init(struct deque *d, void **data_space,
 
 	if (d) {
 		memset(d, 0x00, sizeof(struct deque));
+	} else if (!data_space && !aligned) {
+		/* one allocation: the struct, followed by the data_space,
+		   which is moved out of line if it grows; by default, the
+		   block is the size that the data_space alone would be, to
+		   stay within the same size class of the allocator */
+		if (!data_space_len) {
+			data_space_len = Deque_default_inline_len;
+		}
+		size = sizeof(void *) * data_space_len;
+		if (data_space_len > (SIZE_MAX - sizeof(struct deque))
+		    / sizeof(void *)) {
+			return NULL;
+		}
+		if (no_scrub) {
+			d = (struct deque *)ea->malloc(ea, sizeof(struct deque)
+						       + size);
+			if (d) {
+				eembed_memset(d, 0x00, sizeof(struct deque));
+			}
+		} else {
+			d = (struct deque *)ea->calloc(ea, 1,
+						       sizeof(struct deque)
+						       + size);
+		}
+		if (!d) {
+			return NULL;
+		}
+		d->flags.deque_needs_free = 1;
+		data_space = deque_inline_space(d);
+		/* already zeroed by calloc, if needed at all */
+		scrub = 0;
 	} else {
-		d = (struct deque *)ea->calloc(ea, 1, sizeof(struct deque));
+		d = deque_struct_alloc(ea, aligned);
 		if (!d) {
 			return NULL;
 		}
@@ -252,17 +1217,24 @@ struct deque *deque_init(struct deque *d, void **data_space,
 		if (!data_space_len) {
 			data_space_len = Deque_default_len;
 		}
-		data_space =
-		    (void **)ea->calloc(ea, data_space_len, sizeof(void *));
+		data_space = deque_space_alloc(ea, data_space_len, aligned,
+					       !no_scrub, &pad);
 		if (!data_space) {
 			if (d->flags.deque_needs_free) {
-				ea->free(ea, d);
+				deque_struct_free(ea, d, aligned);
 			}
 			return NULL;
 		}
 		d->flags.data_space_needs_free = 1;
+		/* already zeroed by calloc, if needed at all */
+		scrub = 0;
 	}
 
+	d->flags.ring = (options & Deque_option_ring) ? 1 : 0;
+	d->flags.no_scrub = no_scrub;
+	d->flags.secure_scrub = secure_scrub;
+	d->flags.aligned = aligned;
+	d->flags.align_pad = (uint8_t)pad;
 	d->data_space = data_space;
 	d->data_space_len = data_space_len;
 	d->first_pos = Deque_default_unshift_space(d->data_space_len);
@@ -271,7 +1243,10 @@ struct deque *deque_init(struct deque *d, void **data_space,
 
 	deque_assert(d);
 
-	eembed_memset(d->data_space, 0x00, data_space_len * sizeof(void *));
+	if (scrub) {
+		eembed_memset(d->data_space, 0x00,
+			      data_space_len * sizeof(void *));
+	}
 
 	return d;
 }
@@ -303,15 +1278,15 @@ struct deque *deque_new_no_allocator(unsigned char *bytes, size_t bytes_len)
 	/* we need at least room for the structs and the default length */
 	min_size = eembed_align(sizeof(struct deque)) + (4 * sizeof(void *));
 
-	/* if we grow more than 88 bytes, we should bump the version
+	/* if we grow more than 96 bytes, we should bump the version
 	 * and update deque.h and docs */
-	eembed_assert(min_size <= 88);
+	eembed_assert(min_size <= 96);
 
 	if (bytes_len < min_size) {
 		return NULL;
 	}
 
-	eembed_memset(bytes, 0x00, bytes_len);
+	/* deque_init zeroes the struct and the data_space */
 	d = (struct deque *)bytes;
 	used = eembed_align(sizeof(struct deque));
 	data_space = (void **)(bytes + used);
@@ -323,6 +1298,7 @@ struct deque *deque_new_no_allocator(unsigned char *bytes, size_t bytes_len)
 void deque_free(struct deque *d)
 {
 	struct eembed_allocator *ea = NULL;
+	int aligned = 0;
 
 	if (!d) {
 		return;
@@ -331,20 +1307,35 @@ void deque_free(struct deque *d)
 	eembed_assert(d->ea);
 
 	ea = d->ea;
+	aligned = d->flags.aligned;
 
 	if (d->flags.data_space_needs_free) {
-		ea->free(ea, d->data_space);
+		if (d->flags.secure_scrub) {
+			deque_secure_zero(d->data_space,
+					  d->data_space_len * sizeof(void *));
+		}
+		deque_space_free(d);
 		d->data_space = NULL;
 		d->data_space_len = 0;
 		d->flags.data_space_needs_free = 0;
+		d->flags.align_pad = 0;
 		d->first_pos = 0;
 		d->end_pos = 0;
-	} else {
+	} else if (d->flags.secure_scrub) {
+		deque_secure_zero(d->data_space,
+				  d->data_space_len * sizeof(void *));
+	} else if (!d->flags.no_scrub
+		   && !(d->flags.deque_needs_free
+			&& d->data_space == deque_inline_space(d))) {
+		/* a caller's data_space; an inline one is freed with d */
 		size_t size = d->data_space_len * sizeof(void *);
 		eembed_memset(d->data_space, 0x00, size);
 	}
 	if (d->flags.deque_needs_free) {
-		ea->free(ea, d);
+		if (d->flags.secure_scrub) {
+			deque_secure_zero(d, sizeof(struct deque));
+		}
+		deque_struct_free(ea, d, aligned);
 	} else {
 		d->end_pos = d->first_pos;
 	}
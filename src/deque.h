@@ -58,32 +58,162 @@ Deque_begin_C_declarations;
 #define Deque_default_unshift_space(data_space_len) (data_space_len/4)
 #endif
 
+/* used by the concurrent variants to keep hot fields apart */
+#ifndef Deque_cache_line
+#define Deque_cache_line 64
+#endif
+
+struct deque;
+
+/* chooses the new length of a full data_space; the result must be at
+   least min_len, "unshifting" is non-zero if growing for the front */
+typedef size_t (*deque_grow_func)(struct deque *d, size_t min_len,
+				  int unshifting, void *context);
+
+/* instrumentation hooks, called after the data_space has grown, or
+   after "items_moved" items were moved within it to make room */
+typedef void (*deque_grow_hook)(struct deque *d, size_t old_len,
+				size_t new_len, void *context);
+typedef void (*deque_recenter_hook)(struct deque *d, size_t items_moved,
+				    void *context);
+
+/* optional tuning, may be shared by many deques; NULL for the defaults */
+struct deque_policy {
+	/* automatically halve the data_space when fewer than
+	   1/shrink_divisor of the slots are in use; 0 never shrinks.
+	   Values below 4 are treated as 4, so that a halved data_space is
+	   at most half full, and will not be grown again right away. */
+	size_t shrink_divisor;
+
+	/* do not automatically shrink below this many slots,
+	   if 0, then Deque_default_len */
+	size_t shrink_min_len;
+
+	/* grow to this percent of the current length, e.g. 150;
+	   100 or less (including 0) grows to 200 percent, doubling */
+	size_t grow_percent;
+
+	/* if non-zero, grow by no more than this many slots at a time,
+	   thus the growth of large deques becomes linear */
+	size_t grow_max_step;
+
+	/* when growing, the percent of the new spare slots to place
+	   before the items (1 to 100); if 0, then half of them when
+	   pushing, and all of them when unshifting */
+	size_t front_percent;
+
+	/* if set, chooses the new length, rather than the above */
+	deque_grow_func grow_func;
+	void *grow_context;
+
+	/* if set, called on grow and on re-centering, with hook_context */
+	deque_grow_hook on_grow;
+	deque_recenter_hook on_recenter;
+	void *hook_context;
+};
+
+/* operation counts, only kept if libdeque is built with Deque_stats,
+   ( ./configure --enable-stats ) see deque_set_stats */
+struct deque_stats {
+	size_t pushes;
+	size_t pops;
+	size_t shifts;
+	size_t unshifts;
+
+	/* moving the items within the data_space, to make room at an end */
+	size_t recenters;
+	/* resizing the data_space, each is an allocator call */
+	size_t grows;
+	size_t shrinks;
+	/* by recentering, and by resizing */
+	uint64_t bytes_moved;
+
+	size_t peak_size;
+	size_t peak_capacity;
+};
+
+/* an external iterator, see deque_cursor_init; any change to the deque
+   makes the cursor invalid */
+struct deque_cursor {
+	void **a;
+	size_t a_len;
+	void **b;
+	size_t b_len;
+	/* the index of the next item, counting from the bottom */
+	size_t index;
+};
+
 struct deque {
+	/* read by every push, pop, shift, and unshift, thus first, in the
+	   first 40 bytes: one cache line if the struct starts on a line, as
+	   with Deque_option_aligned, else at most two */
 	size_t first_pos;
 	size_t end_pos;
-	struct eembed_allocator *ea;
+	void **data_space;
+	size_t data_space_len;
 	union {
 		struct {
 			uint8_t deque_needs_free:1;
 			uint8_t data_space_needs_free:1;
-			uintptr_t reserved:((sizeof(uintptr_t) * CHAR_BIT) - 2);
+			uint8_t ring:1;
+			uint8_t no_scrub:1;
+			uint8_t secure_scrub:1;
+			uint8_t aligned:1;
+			/* slots skipped to align an owned data_space, in
+			   the second byte */
+			uint8_t align_pad:8;
 		}
 		flags;
 		uintptr_t all_flags;
 	};
-	void *reseverd_for_future_use;
-	size_t data_space_len;
-	void **data_space;
+
+	/* only when growing, shrinking, or freeing */
+	const struct deque_policy *policy;
+	struct deque_stats *stats;
+	struct eembed_allocator *ea;
 };
 
+/* options for deque_init_options, may be OR-ed together */
+/* ring: head and tail wrap around data_space, no memmove on push/unshift */
+#define Deque_option_ring (1U << 0)
+
+/* by default, slots are set to NULL as items are removed, as is a data_space
+   which was passed in to deque_init, both at init and at deque_free */
+/* no_scrub: skip all of that, vacated slots keep stale pointers */
+#define Deque_option_no_scrub (1U << 1)
+/* secure_scrub: as the default, but also zero the data_space and struct
+   before they are freed, zero the items on deque_clear, and on resize
+   never use realloc, which may leave a copy; overrides no_scrub */
+#define Deque_option_secure_scrub (1U << 2)
+
+/* aligned: an allocated data_space starts on a Deque_cache_line boundary,
+   thus bulk and SIMD access to it does not split lines at the start;
+   such a data_space is not grown with realloc, which may not keep it.
+   An allocated struct also starts on a line, and is kept apart from
+   its data_space */
+#define Deque_option_aligned (1U << 3)
+
 /* passed parameter functions */
 typedef int (*deque_iterator_func)(struct deque *d, void *each, void *context);
 
-/* initialize the deque data_space using the custom allocator */
+/* less than zero if a is before b, zero if equal, else greater than zero */
+typedef int (*deque_compare_func)(void *a, void *b, void *context);
+
+/* initialize the deque data_space using the custom allocator;
+   if d and data_space are both NULL, they are one allocation, the
+   data_space following the struct until it grows, and a data_space_len
+   of 0 is then Deque_default_len less the slots the struct takes,
+   but at least 4 */
 struct deque *deque_init(struct deque *d,
 			 void **data_space,
 			 size_t data_space_len, struct eembed_allocator *ea);
 
+/* as deque_init, with Deque_option_ flags to select the storage mode */
+struct deque *deque_init_options(struct deque *d,
+				 void **data_space,
+				 size_t data_space_len,
+				 struct eembed_allocator *ea, unsigned options);
+
 /* add items to the end of queue (or top of stack): */
 struct deque *deque_push(struct deque *d, void *data);
 
@@ -96,6 +226,100 @@ struct deque *deque_unshift(struct deque *d, void *data);
 /* remove item from front of queue (or bottom of stack): */
 void *deque_shift(struct deque *d);
 
+/* add n items to the end, as if by deque_push of each in turn */
+struct deque *deque_push_n(struct deque *d, void **items, size_t n);
+
+/* remove up to n items from the end into out, returns the count removed;
+   out[0] is the item which deque_pop would have returned first */
+size_t deque_pop_n(struct deque *d, void **out, size_t n);
+
+/* prepend n items, as if by deque_unshift of each in turn */
+struct deque *deque_unshift_n(struct deque *d, void **items, size_t n);
+
+/* remove up to n items from the front into out, returns the count */
+size_t deque_shift_n(struct deque *d, void **out, size_t n);
+
+/* returned by deque_find and deque_find_last if the item is not found */
+#define Deque_not_found ((size_t)-1)
+
+/* the index, counting from the bottom, of the first item equal to the
+   pointer, or Deque_not_found; compared many at a time where the CPU
+   supports it, see deque-find.c */
+size_t deque_find(struct deque *d, const void *item);
+
+/* as deque_find, but the index of the last (closest to the top) item */
+size_t deque_find_last(struct deque *d, const void *item);
+
+/* non-zero if an item is equal to the pointer */
+int deque_contains(struct deque *d, const void *item);
+
+/* the number of items equal to the pointer */
+size_t deque_count(struct deque *d, const void *item);
+
+/* sort the items in place, from the bottom up, see deque-sort.c; the
+   order of equal items is not kept */
+void deque_sort(struct deque *d, deque_compare_func cmp, void *context);
+
+/* in a sorted deque, the index of the first item which is not before
+   (lower) or which is after (upper) the item; deque_size(d) if none */
+size_t deque_lower_bound(struct deque *d, void *item, deque_compare_func cmp,
+			 void *context);
+size_t deque_upper_bound(struct deque *d, void *item, deque_compare_func cmp,
+			 void *context);
+
+/* insert in to a sorted deque, after any equal items */
+struct deque *deque_insert_sorted(struct deque *d, void *item,
+				  deque_compare_func cmp, void *context);
+
+/* move the items of the sorted src in to the sorted dst, in order, with
+   those from dst before any equal items from src; src is left empty.
+   Returns NULL, with both unchanged, if out of memory (or if dst is src) */
+struct deque *deque_merge(struct deque *dst, struct deque *src,
+			  deque_compare_func cmp, void *context);
+
+/* insert the item so that it is at index, counting from the bottom, and
+   the items from index onward move up by one; an index of deque_size(d)
+   is the same as deque_push. Whichever side of index has fewer items is
+   moved. Returns NULL if index is past the top, or if out of memory */
+struct deque *deque_insert_at(struct deque *d, size_t index, void *data);
+
+/* remove and return the item at index, counting from the bottom, moving
+   the shorter side to close the gap; NULL if index is past the top */
+void *deque_erase_at(struct deque *d, size_t index);
+
+/* remove the items from index "from" up to, but not including, index
+   "to", limited to the size; returns the count removed */
+size_t deque_erase_range(struct deque *d, size_t from, size_t to);
+
+/* remove every item for which pred returns non-zero, keeping the order
+   of the rest, in one pass; pred must not change the deque. Returns the
+   count removed */
+size_t deque_remove_if(struct deque *d, deque_iterator_func pred,
+		       void *context);
+
+/* ensure room to unshift front_slots and push back_slots items without
+   allocating; returns NULL if the space can not be made */
+struct deque *deque_reserve(struct deque *d, size_t front_slots,
+			    size_t back_slots);
+
+/* return the number of slots in the data_space */
+size_t deque_capacity(struct deque *d);
+
+/* release unused space, leaving room for only the current items */
+struct deque *deque_shrink_to_fit(struct deque *d);
+
+/* use the policy for this deque, or the defaults if NULL */
+void deque_set_policy(struct deque *d, const struct deque_policy *policy);
+
+/* count the operations on this deque into the caller's stats, which may
+   be shared by many deques; the stats are not zeroed here; NULL to stop
+   counting; returns NULL if libdeque was not built with Deque_stats */
+struct deque *deque_set_stats(struct deque *d, struct deque_stats *stats);
+
+/* copy the stats into "out", returns 0 on success, or -1 (with out
+   zeroed) if no stats are attached or libdeque lacks Deque_stats */
+int deque_stats(struct deque *d, struct deque_stats *out);
+
 /* reset the deque to an empty state */
 void deque_clear(struct deque *d);
 
@@ -111,6 +335,33 @@ size_t deque_size(struct deque *d);
 /* internal iterator */
 int deque_for_each(struct deque *d, deque_iterator_func func, void *context);
 
+/* as deque_for_each, but from the top (end of the queue) to the bottom */
+int deque_for_each_reverse(struct deque *d, deque_iterator_func func,
+			   void *context);
+
+/* as deque_for_each, but only the items from index "from" up to, but not
+   including, index "to", counting from the bottom, limited to the size */
+int deque_for_each_range(struct deque *d, size_t from, size_t to,
+			 deque_iterator_func func, void *context);
+
+/* the items, in order, are the a_len slots at *a, followed by the b_len
+   slots at *b; these are valid until the deque is next changed.
+   returns the number of non-empty spans: 0, 1, or 2 (if a ring wraps) */
+int deque_as_spans(struct deque *d, void ***a, size_t *a_len, void ***b,
+		   size_t *b_len);
+
+/* position the cursor before the item at index, counting from the
+   bottom; an index of deque_size(d) (or more) is after the top item */
+struct deque_cursor *deque_cursor_init(struct deque_cursor *c,
+				       struct deque *d, size_t index);
+
+/* the slot of the next item, moving toward the top; NULL at the end */
+void **deque_cursor_next(struct deque_cursor *c);
+
+/* the slot of the previous item, moving toward the bottom; NULL at the
+   start */
+void **deque_cursor_prev(struct deque_cursor *c);
+
 struct deque *deque_new(void);
 struct deque *deque_new_custom_allocator(struct eembed_allocator *ea);
 struct deque *deque_new_no_allocator(unsigned char *bytes, size_t bytes_len);
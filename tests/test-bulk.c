@@ -0,0 +1,138 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-bulk.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+#define Test_bulk_len 300
+
+unsigned check_same(struct deque *a, struct deque *b, const char *msg)
+{
+	unsigned failures = 0;
+	size_t i;
+
+	failures += check_size_t_m(deque_size(a), deque_size(b), msg);
+	for (i = 0; i < deque_size(a); ++i) {
+		failures += check_ptr_m(deque_peek_bottom(a, i),
+					deque_peek_bottom(b, i), msg);
+	}
+	return failures;
+}
+
+unsigned test_bulk_options(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque *bulk = NULL;
+	struct deque *loop = NULL;
+	char vals[Test_bulk_len];
+	void *items[Test_bulk_len];
+	void *out_bulk[Test_bulk_len];
+	void *out_loop[Test_bulk_len];
+	size_t i, got;
+
+	for (i = 0; i < Test_bulk_len; ++i) {
+		items[i] = &vals[i];
+	}
+
+	bulk = deque_init_options(NULL, NULL, 4, NULL, options);
+	loop = deque_init_options(NULL, NULL, 4, NULL, options);
+	if (!bulk || !loop) {
+		check_int(0, 1);
+		deque_free(bulk);
+		deque_free(loop);
+		return 1;
+	}
+
+	/* enough to force growth */
+	failures += check_ptr(deque_push_n(bulk, items, 100), bulk);
+	for (i = 0; i < 100; ++i) {
+		deque_push(loop, items[i]);
+	}
+	failures += check_same(bulk, loop, "push_n");
+
+	failures += check_ptr(deque_unshift_n(bulk, items + 100, 150), bulk);
+	for (i = 0; i < 150; ++i) {
+		deque_unshift(loop, items[100 + i]);
+	}
+	failures += check_same(bulk, loop, "unshift_n");
+
+	got = deque_pop_n(bulk, out_bulk, 30);
+	failures += check_size_t_m(got, 30, "pop_n count");
+	for (i = 0; i < 30; ++i) {
+		out_loop[i] = deque_pop(loop);
+		failures += check_ptr_m(out_bulk[i], out_loop[i], "pop_n");
+	}
+	failures += check_same(bulk, loop, "after pop_n");
+
+	got = deque_shift_n(bulk, out_bulk, 70);
+	failures += check_size_t_m(got, 70, "shift_n count");
+	for (i = 0; i < 70; ++i) {
+		out_loop[i] = deque_shift(loop);
+		failures += check_ptr_m(out_bulk[i], out_loop[i], "shift_n");
+	}
+	failures += check_same(bulk, loop, "after shift_n");
+
+	/* zero length, and more than is present */
+	failures += check_ptr(deque_push_n(bulk, items, 0), bulk);
+	failures += check_size_t(deque_shift_n(bulk, out_bulk, 0), 0);
+	got = deque_shift_n(bulk, out_bulk, Test_bulk_len);
+	failures += check_size_t_m(got, 150, "shift_n all");
+	failures += check_ptr_m(out_bulk[0], deque_shift(loop), "first");
+	failures += check_size_t(deque_size(bulk), 0);
+	failures += check_size_t(deque_pop_n(bulk, out_bulk, 5), 0);
+
+	/* usable after draining */
+	failures += check_ptr(deque_unshift_n(bulk, items, 3), bulk);
+	failures += check_ptr(deque_pop(bulk), items[0]);
+	failures += check_ptr(deque_shift(bulk), items[2]);
+
+	deque_free(bulk);
+	deque_free(loop);
+
+	return failures;
+}
+
+unsigned test_bulk_no_allocator(void)
+{
+	unsigned failures = 0;
+	unsigned char bytes[200];
+	struct deque *d = NULL;
+	void *items[40];
+	size_t i;
+
+	for (i = 0; i < 40; ++i) {
+		items[i] = &items[i];
+	}
+
+	d = deque_new_no_allocator(bytes, sizeof(bytes));
+	if (!d) {
+		check_int(0, 1);
+		return 1;
+	}
+
+	failures += check_ptr_m(deque_push_n(d, items, 40), NULL, "too many");
+	failures += check_size_t_m(deque_size(d), 0, "unchanged");
+	failures += check_ptr(deque_push_n(d, items, 10), d);
+	failures += check_ptr(deque_unshift_n(d, items + 10, 5), d);
+	failures += check_size_t(deque_size(d), 15);
+	failures += check_ptr(deque_peek_bottom(d, 0), items[14]);
+	failures += check_ptr(deque_peek_top(d, 0), items[9]);
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_bulk(void)
+{
+	unsigned failures = 0;
+
+	failures += test_bulk_options(0);
+	failures += test_bulk_options(Deque_option_ring);
+	failures += test_bulk_no_allocator();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_bulk)
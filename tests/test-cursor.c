@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-cursor.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+/* appends the index of each item, as a digit */
+int append_digit(struct deque *d, void *each, void *context)
+{
+	char *buf = (char *)context;
+	size_t len = eembed_strlen(buf);
+	(void)d;
+	buf[len] = (char)('0' + ((uintptr_t)each - 1));
+	buf[len + 1] = '\0';
+	return 0;
+}
+
+int stop_at_five(struct deque *d, void *each, void *context)
+{
+	(void)d;
+	(void)context;
+	return (each == item(5)) ? 5 : 0;
+}
+
+/* items 0 through 6, wrapped around the end of a ring of 8 slots:
+   the ring starts at slot 2, thus 4 in and out leaves the front at 6 */
+struct deque *wrapped_ring(void)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 8, NULL,
+					     Deque_option_ring);
+	size_t i;
+
+	if (!d) {
+		return NULL;
+	}
+	for (i = 0; i < 4; ++i) {
+		deque_push(d, d);
+	}
+	for (i = 0; i < 4; ++i) {
+		deque_shift(d);
+	}
+	for (i = 0; i < 7; ++i) {
+		deque_push(d, item(i));
+	}
+	return d;
+}
+
+unsigned test_spans(void)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	void **a, **b;
+	size_t a_len, b_len, i;
+
+	d = deque_new();
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_int(deque_as_spans(d, &a, &a_len, &b, &b_len), 0);
+	failures += check_size_t(a_len + b_len, 0);
+	deque_unshift(d, item(1));
+	deque_unshift(d, item(0));
+	deque_push(d, item(2));
+	failures += check_int(deque_as_spans(d, &a, &a_len, &b, &b_len), 1);
+	failures += check_size_t(a_len, 3);
+	failures += check_size_t(b_len, 0);
+	for (i = 0; i < a_len; ++i) {
+		failures += check_ptr(a[i], item(i));
+	}
+	deque_free(d);
+
+	d = wrapped_ring();
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_int(deque_as_spans(d, &a, &a_len, &b, &b_len), 2);
+	failures += check_size_t(a_len, 2);
+	failures += check_size_t(b_len, 5);
+	for (i = 0; i < a_len; ++i) {
+		failures += check_ptr(a[i], item(i));
+	}
+	for (i = 0; i < b_len; ++i) {
+		failures += check_ptr(b[i], item(a_len + i));
+	}
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_cursor(struct deque *d)
+{
+	unsigned failures = 0;
+	struct deque_cursor c;
+	void **slot;
+	size_t i;
+
+	deque_cursor_init(&c, d, 0);
+	failures += check_ptr(deque_cursor_prev(&c), NULL);
+	for (i = 0; (slot = deque_cursor_next(&c)) != NULL; ++i) {
+		failures += check_ptr(*slot, item(i));
+	}
+	failures += check_size_t(i, 7);
+
+	/* and back again, from the end */
+	for (i = 7; (slot = deque_cursor_prev(&c)) != NULL; --i) {
+		failures += check_ptr(*slot, item(i - 1));
+	}
+	failures += check_size_t(i, 0);
+
+	deque_cursor_init(&c, d, 3);
+	failures += check_ptr(*deque_cursor_next(&c), item(3));
+	failures += check_ptr(*deque_cursor_prev(&c), item(3));
+	failures += check_ptr(*deque_cursor_prev(&c), item(2));
+
+	/* the slot may be written */
+	deque_cursor_init(&c, d, 100);
+	slot = deque_cursor_prev(&c);
+	*slot = item(9);
+	failures += check_ptr(deque_peek_top(d, 0), item(9));
+	*slot = item(6);
+	failures += check_ptr(deque_cursor_next(&c), slot);
+	failures += check_ptr(deque_cursor_next(&c), NULL);
+
+	return failures;
+}
+
+unsigned test_for_each_variants(struct deque *d)
+{
+	unsigned failures = 0;
+	char buf[20];
+
+	buf[0] = '\0';
+	failures += check_int(deque_for_each_reverse(d, append_digit, buf), 0);
+	failures += check_str(buf, "6543210");
+	failures += check_int(deque_for_each_reverse(d, stop_at_five, NULL), 5);
+
+	buf[0] = '\0';
+	failures +=
+	    check_int(deque_for_each_range(d, 1, 5, append_digit, buf), 0);
+	failures += check_str(buf, "1234");
+
+	buf[0] = '\0';
+	failures +=
+	    check_int(deque_for_each_range(d, 4, 100, append_digit, buf), 0);
+	failures += check_str(buf, "456");
+
+	buf[0] = '\0';
+	failures +=
+	    check_int(deque_for_each_range(d, 5, 2, append_digit, buf), 0);
+	failures += check_str(buf, "");
+
+	failures +=
+	    check_int(deque_for_each_range(d, 0, 5, stop_at_five, NULL), 0);
+	failures +=
+	    check_int(deque_for_each_range(d, 0, 6, stop_at_five, NULL), 5);
+
+	return failures;
+}
+
+unsigned test_cursors(void)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	size_t i;
+
+	failures += test_spans();
+
+	d = wrapped_ring();
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += test_cursor(d);
+	failures += test_for_each_variants(d);
+	deque_free(d);
+
+	d = deque_new();
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	for (i = 0; i < 7; ++i) {
+		deque_push(d, item(i));
+	}
+	failures += test_cursor(d);
+	failures += test_for_each_variants(d);
+	deque_free(d);
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_cursors)
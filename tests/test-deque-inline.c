@@ -0,0 +1,223 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-deque-inline.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-inline.h"
+#include "echeck.h"
+
+struct message {
+	uint32_t id;
+	uint16_t kind;
+	char text[18];
+};
+
+static void message_init(struct message *m, uint32_t id)
+{
+	eembed_memset(m, 0x00, sizeof(struct message));
+	m->id = id;
+	m->kind = (uint16_t)(id % 7);
+	m->text[0] = (char)('a' + (id % 26));
+}
+
+int sum_ids(struct deque_inline *d, void *each, void *context)
+{
+	struct message *m = (struct message *)each;
+	uint32_t *sum = (uint32_t *)context;
+	(void)d;
+	*sum += m->id;
+	return 0;
+}
+
+unsigned check_message(struct message *m, uint32_t id)
+{
+	unsigned failures = 0;
+
+	if (!m) {
+		return check_int(m != NULL ? 1 : 0, 1);
+	}
+	failures += check_unsigned_int_m(m->id, id, "id");
+	failures += check_unsigned_int_m(m->kind, id % 7, "kind");
+	failures += check_int_m(m->text[0], 'a' + (int)(id % 26), "text");
+
+	return failures;
+}
+
+unsigned test_deque_inline_ends(int front_first,
+				struct eembed_allocator *ea)
+{
+	unsigned failures = 0;
+	struct deque_inline *d = NULL;
+	struct message m;
+	uint32_t i, sum = 0;
+
+	d = deque_inline_init(NULL, sizeof(struct message), 4, ea);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	failures += check_ptr(deque_inline_pop(d, &m), NULL);
+	failures += check_ptr(deque_inline_shift(d, &m), NULL);
+	failures += check_ptr(deque_inline_peek_top(d, 0), NULL);
+
+	/* from both ends, so the ring is wrapped when it grows */
+	for (i = 1; i <= 50; ++i) {
+		message_init(&m, i);
+		if (front_first) {
+			failures += check_ptr(deque_inline_unshift(d, &m), d);
+		} else {
+			failures += check_ptr(deque_inline_push(d, &m), d);
+		}
+		message_init(&m, 1000 + i);
+		if (front_first) {
+			failures += check_ptr(deque_inline_push(d, &m), d);
+		} else {
+			failures += check_ptr(deque_inline_unshift(d, &m), d);
+		}
+	}
+	failures += check_size_t(deque_inline_size(d), 100);
+	failures += check_int_m(deque_inline_capacity(d) >= 100, 1, "grew");
+
+	for (i = 0; i < 50; ++i) {
+		failures += check_message((struct message *)
+					  deque_inline_peek_bottom(d, i),
+					  front_first ? (50 - i) : (1050 - i));
+		failures += check_message((struct message *)
+					  deque_inline_peek_top(d, i),
+					  front_first ? (1050 - i) : (50 - i));
+	}
+	failures += check_ptr(deque_inline_peek_bottom(d, 100), NULL);
+
+	failures += check_int(deque_inline_for_each(d, sum_ids, &sum), 0);
+	failures += check_unsigned_int(sum, (2 * 1275) + (50 * 1000));
+
+	for (i = 0; i < 50; ++i) {
+		failures += check_ptr(deque_inline_pop(d, &m), d);
+		failures +=
+		    check_message(&m, front_first ? (1050 - i) : (50 - i));
+		failures += check_ptr(deque_inline_shift(d, &m), d);
+		failures +=
+		    check_message(&m, front_first ? (50 - i) : (1050 - i));
+	}
+	failures += check_size_t(deque_inline_size(d), 0);
+
+	/* out may be NULL, simply discarding the element */
+	message_init(&m, 7);
+	deque_inline_push(d, &m);
+	failures += check_ptr(deque_inline_shift(d, NULL), d);
+	failures += check_size_t(deque_inline_size(d), 0);
+
+	deque_inline_free(d);
+
+	return failures;
+}
+
+unsigned test_deque_inline_no_allocator(void)
+{
+	unsigned failures = 0;
+	unsigned char bytes[256];
+	struct deque_inline *d = NULL;
+	struct message m;
+	size_t i, len;
+
+	failures += check_ptr(deque_inline_new_no_allocator(0, bytes, 256),
+			      NULL);
+	failures += check_ptr(deque_inline_new_no_allocator(8, bytes, 8), NULL);
+
+	d = deque_inline_new_no_allocator(sizeof(struct message), bytes,
+					  sizeof(bytes));
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	len = deque_inline_capacity(d);
+	failures += check_int_m(len > 0, 1, "capacity");
+	failures += check_int_m((d->data_space + (len * d->elem_size))
+				<= (bytes + sizeof(bytes)), 1, "fits");
+
+	/* wrap around, without growing */
+	for (i = 0; i < 3 * len; ++i) {
+		message_init(&m, (uint32_t)i);
+		failures += check_ptr(deque_inline_push(d, &m), d);
+		if (deque_inline_size(d) == len) {
+			failures += check_ptr_m(deque_inline_push(d, &m), NULL,
+						"full");
+			deque_inline_shift(d, NULL);
+		}
+	}
+	failures += check_message((struct message *)
+				  deque_inline_peek_top(d, 0),
+				  (uint32_t)((3 * len) - 1));
+
+	deque_inline_free(d);
+
+	return failures;
+}
+
+unsigned test_deque_inline_out_of_memory(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct deque_inline *d = NULL;
+	struct message m;
+	size_t i, len;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+
+	d = deque_inline_new_custom_allocator(sizeof(struct message), &wrap);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	len = deque_inline_capacity(d);
+	for (i = 0; i < len; ++i) {
+		message_init(&m, (uint32_t)i);
+		deque_inline_unshift(d, &m);
+	}
+
+	ctx.attempts = 0;
+	ctx.attempts_to_fail_bitmask = 0x01;
+	failures += check_ptr(deque_inline_push(d, &m), NULL);
+	failures += check_size_t(deque_inline_size(d), len);
+	failures += check_size_t(deque_inline_capacity(d), len);
+	failures += check_message((struct message *)
+				  deque_inline_peek_bottom(d, 0),
+				  (uint32_t)(len - 1));
+
+	ctx.attempts_to_fail_bitmask = 0;
+	message_init(&m, 12345);
+	failures += check_ptr(deque_inline_push(d, &m), d);
+	failures += check_message((struct message *)
+				  deque_inline_peek_top(d, 0), 12345);
+
+	deque_inline_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+unsigned test_deque_inline(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator no_realloc;
+
+	/* the same allocator, but growing by malloc, copy, and free */
+	no_realloc = *eembed_global_allocator;
+	no_realloc.realloc = NULL;
+
+	failures += test_deque_inline_ends(0, NULL);
+	failures += test_deque_inline_ends(1, NULL);
+	failures += test_deque_inline_ends(0, &no_realloc);
+	failures += test_deque_inline_ends(1, &no_realloc);
+	failures += test_deque_inline_no_allocator();
+	failures += test_deque_inline_out_of_memory();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_inline)
@@ -0,0 +1,186 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-deque-mmap.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-mmap.h"
+#include "echeck.h"
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+#define Test_min_bytes (64 * 1024)
+
+/* count the bytes which do not match the pattern */
+size_t check_bytes(unsigned char *p, size_t from, size_t to)
+{
+	size_t i, wrong = 0;
+
+	for (i = from; i < to; ++i) {
+		wrong += (p[i] != (unsigned char)(i % 251));
+	}
+	return wrong;
+}
+
+void fill_bytes(unsigned char *p, size_t from, size_t to)
+{
+	size_t i;
+
+	for (i = from; i < to; ++i) {
+		p[i] = (unsigned char)(i % 251);
+	}
+}
+
+unsigned test_mmap_allocator(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque_mmap_allocator mm;
+	struct eembed_allocator *ea = NULL;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	unsigned char *small = NULL, *big = NULL, *zeroed = NULL;
+	size_t i, nonzero = 0;
+	size_t len = 3 * Test_min_bytes;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+	ea = deque_mmap_allocator_init(&mm, &wrap, Test_min_bytes, options);
+	failures += check_ptr(ea, &mm.ea);
+
+	small = (unsigned char *)ea->malloc(ea, 100);
+	big = (unsigned char *)ea->malloc(ea, len);
+	zeroed = (unsigned char *)ea->calloc(ea, len / 8, 8);
+	if (!small || !big || !zeroed) {
+		check_int((small && big && zeroed) ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_int(deque_mmap_is_mapped(ea, small), 0);
+	failures += check_int(deque_mmap_is_mapped(ea, big), 1);
+	failures += check_int(deque_mmap_is_mapped(ea, zeroed), 1);
+	failures += check_unsigned_int_m(ctx.allocs, 1, "small allocs");
+	for (i = 0; i < len; ++i) {
+		nonzero += (zeroed[i] != 0);
+	}
+	failures += check_size_t(nonzero, 0);
+
+	/* small, growing past min_bytes, is moved in to a mapping */
+	fill_bytes(small, 0, 100);
+	small = (unsigned char *)ea->realloc(ea, small, 2 * Test_min_bytes);
+	if (!small) {
+		check_int(small != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_int(deque_mmap_is_mapped(ea, small), 1);
+	failures += check_size_t(check_bytes(small, 0, 100), 0);
+	failures += check_unsigned_int_m(ctx.frees, 1, "small frees");
+
+	/* mapped, grown many times, and shrunk, keeps the contents */
+	fill_bytes(big, 0, len);
+	for (i = 0; i < 5; ++i) {
+		len *= 2;
+		big = (unsigned char *)ea->realloc(ea, big, len);
+		if (!big) {
+			check_int(big != NULL ? 1 : 0, 1);
+			return 1;
+		}
+		failures += check_size_t(check_bytes(big, 0, len / 2), 0);
+		fill_bytes(big, len / 2, len);
+	}
+	big = (unsigned char *)ea->realloc(ea, big, Test_min_bytes / 2);
+	if (!big) {
+		check_int(big != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_int(deque_mmap_is_mapped(ea, big), 1);
+	failures += check_size_t(check_bytes(big, 0, Test_min_bytes / 2), 0);
+	big = (unsigned char *)ea->realloc(ea, big, 4 * Test_min_bytes);
+	if (!big) {
+		check_int(big != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_size_t(check_bytes(big, 0, Test_min_bytes / 2), 0);
+	fill_bytes(big, 0, 4 * Test_min_bytes);
+
+	/* too large, or overflowing */
+	failures += check_ptr(ea->malloc(ea, SIZE_MAX - 8), NULL);
+	failures += check_ptr(ea->calloc(ea, SIZE_MAX / 2, 4), NULL);
+	failures += check_ptr(ea->reallocarray(ea, big, SIZE_MAX / 2, 4),
+			      NULL);
+	failures += check_size_t(check_bytes(big, 0, 4 * Test_min_bytes), 0);
+
+	ea->free(ea, NULL);
+	ea->free(ea, small);
+	ea->free(ea, big);
+	ea->free(ea, zeroed);
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+
+	return failures;
+}
+
+unsigned test_mmap_deque(unsigned options, unsigned deque_options)
+{
+	unsigned failures = 0;
+	struct deque_mmap_allocator mm;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator *ea = NULL;
+	struct deque *d = NULL;
+	size_t i, n = 100 * 1000, wrong = 0;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+	ea = deque_mmap_allocator_init(&mm, &wrap, Test_min_bytes, options);
+
+	d = deque_init_options(NULL, NULL, 0, ea, deque_options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_int(deque_mmap_is_mapped(ea, d), 0);
+	for (i = 0; i < n; ++i) {
+		if (i % 3) {
+			deque_push(d, item(i));
+		} else {
+			deque_unshift(d, item(i));
+		}
+	}
+	failures += check_int(deque_mmap_is_mapped(ea, d->data_space), 1);
+	failures += check_size_t(deque_size(d), n);
+
+	/* the pages past the items are given back, the items remain */
+	for (i = 0; i < (n * 3) / 4; ++i) {
+		deque_pop(d);
+	}
+	failures += check_ptr(deque_shrink_to_fit(d), d);
+	failures += check_size_t(deque_capacity(d), n / 4);
+	for (i = 0; i < deque_size(d); ++i) {
+		wrong += (deque_peek_bottom(d, i) == NULL);
+	}
+	failures += check_size_t(wrong, 0);
+	for (i = 0; i < n; ++i) {
+		deque_push(d, item(i));
+	}
+	failures += check_ptr(deque_peek_top(d, 0), item(n - 1));
+	failures += check_size_t(deque_size(d), n + (n / 4));
+
+	deque_free(d);
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+
+	return failures;
+}
+
+unsigned test_deque_mmap(void)
+{
+	unsigned failures = 0;
+
+	failures += test_mmap_allocator(0);
+	failures += test_mmap_allocator(Deque_mmap_thp);
+	failures += test_mmap_allocator(Deque_mmap_hugetlb);
+
+	failures += test_mmap_deque(0, 0);
+	failures += test_mmap_deque(0, Deque_option_ring);
+	failures += test_mmap_deque(Deque_mmap_thp | Deque_mmap_hugetlb, 0);
+	failures += test_mmap_deque(0, Deque_option_secure_scrub);
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_mmap)
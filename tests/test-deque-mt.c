@@ -0,0 +1,340 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-deque-mt.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-mt.h"
+#include "echeck.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#define Producers 4
+#define Per_producer 50000
+#define Total (Producers * Per_producer)
+
+struct stress_context {
+	struct deque_mt *d;
+	size_t consumed;	/* shared, updated with __atomic */
+	unsigned char *seen;
+};
+
+struct stress_thread {
+	struct stress_context *ctx;
+	size_t id;
+	size_t errors;
+};
+
+/* producers alternate between the ends */
+static void *producer(void *arg)
+{
+	struct stress_thread *t = (struct stress_thread *)arg;
+	struct deque_mt *d = t->ctx->d;
+	size_t i, v;
+
+	for (i = 0; i < Per_producer; ++i) {
+		v = 1 + (t->id * Per_producer) + i;
+		if (((i + t->id) % 2)
+		    ? !deque_mt_push(d, (void *)(uintptr_t)v)
+		    : !deque_mt_unshift(d, (void *)(uintptr_t)v)) {
+			++t->errors;
+		}
+	}
+	return NULL;
+}
+
+/* consumers take from both ends until every item is accounted for */
+static void *consumer(void *arg)
+{
+	struct stress_thread *t = (struct stress_thread *)arg;
+	struct stress_context *ctx = t->ctx;
+	size_t i = 0;
+	uintptr_t v;
+
+	while (__atomic_load_n(&ctx->consumed, __ATOMIC_ACQUIRE) < Total) {
+		if ((++i + t->id) % 3) {
+			v = (uintptr_t)deque_mt_shift(ctx->d);
+		} else {
+			v = (uintptr_t)deque_mt_pop(ctx->d);
+		}
+		if (!v) {
+			continue;
+		}
+		if (v > Total
+		    || __atomic_fetch_add(&ctx->seen[v - 1], 1,
+					  __ATOMIC_RELAXED)) {
+			++t->errors;
+		}
+		__atomic_fetch_add(&ctx->consumed, 1, __ATOMIC_RELEASE);
+	}
+	return NULL;
+}
+
+unsigned test_deque_mt_stress(void)
+{
+	unsigned failures = 0;
+	struct stress_context ctx;
+	struct stress_thread producers[Producers];
+	struct stress_thread consumers[Producers];
+	pthread_t threads[2 * Producers];
+	struct eembed_allocator *ea = eembed_global_allocator;
+	size_t i;
+
+	eembed_memset(&ctx, 0x00, sizeof(struct stress_context));
+	ctx.seen = (unsigned char *)ea->calloc(ea, Total, 1);
+	/* start small, so that it grows while contended */
+	ctx.d = deque_mt_init(NULL, 4, NULL);
+	if (!ctx.seen || !ctx.d) {
+		check_int(0, 1);
+		return 1;
+	}
+
+	for (i = 0; i < Producers; ++i) {
+		producers[i].ctx = &ctx;
+		producers[i].id = i;
+		producers[i].errors = 0;
+		consumers[i] = producers[i];
+		pthread_create(&threads[i], NULL, consumer, &consumers[i]);
+		pthread_create(&threads[Producers + i], NULL, producer,
+			       &producers[i]);
+	}
+	for (i = 0; i < 2 * Producers; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+
+	for (i = 0; i < Producers; ++i) {
+		failures += check_size_t_m(producers[i].errors, 0, "push");
+		failures += check_size_t_m(consumers[i].errors, 0, "dupe");
+	}
+	failures += check_size_t(ctx.consumed, Total);
+	for (i = 0; i < Total; ++i) {
+		if (ctx.seen[i] != 1) {
+			failures += check_int_m(ctx.seen[i], 1, "seen");
+			break;
+		}
+	}
+	failures += check_size_t(deque_mt_size(ctx.d), 0);
+	failures += check_ptr(deque_mt_pop(ctx.d), NULL);
+	failures += check_ptr(deque_mt_shift(ctx.d), NULL);
+
+	deque_mt_free(ctx.d);
+	ea->free(ea, ctx.seen);
+
+	return failures;
+}
+
+unsigned test_deque_mt_single_thread(void)
+{
+	unsigned failures = 0;
+	struct deque_mt *d = NULL;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator wrap;
+	struct eembed_allocator *real = eembed_global_allocator;
+	struct eembed_log *elog = eembed_err_log;
+	size_t i;
+
+	echeck_err_injecting_allocator_init(&wrap, real, &ctx, elog);
+
+	d = deque_mt_init(NULL, 3, &wrap);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_size_t(d->mask + 1, 4);
+
+	for (i = 1; i <= 10; ++i) {
+		failures +=
+		    check_ptr(deque_mt_push(d, (void *)(uintptr_t)i), d);
+	}
+	failures += check_ptr(deque_mt_unshift(d, (void *)(uintptr_t)0), d);
+	failures += check_size_t(deque_mt_size(d), 11);
+
+	/* a failed allocation leaves the deque as it was */
+	while (deque_mt_size(d) < d->mask + 1) {
+		deque_mt_push(d, NULL);
+	}
+	ctx.attempts_to_fail_bitmask = ~0UL;
+	failures += check_ptr(deque_mt_push(d, NULL), NULL);
+	failures += check_ptr(deque_mt_unshift(d, NULL), NULL);
+	ctx.attempts_to_fail_bitmask = 0;
+	while (deque_mt_size(d) > 11) {
+		failures += check_ptr(deque_mt_pop(d), NULL);
+	}
+
+	for (i = 0; i < 5; ++i) {
+		failures +=
+		    check_ptr(deque_mt_shift(d), (void *)(uintptr_t)i);
+	}
+	for (i = 10; i > 4; --i) {
+		failures += check_ptr(deque_mt_pop(d), (void *)(uintptr_t)i);
+	}
+	failures += check_size_t(deque_mt_size(d), 0);
+	failures += check_ptr(deque_mt_pop(d), NULL);
+
+	deque_mt_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+static uint64_t now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (((uint64_t)ts.tv_sec) * 1000) + (ts.tv_nsec / (1000 * 1000));
+}
+
+unsigned test_deque_mt_wait_timeout(void)
+{
+	unsigned failures = 0;
+	struct deque_mt *d = NULL;
+	void *out = NULL;
+	uint64_t start;
+
+	d = deque_mt_new();
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	failures += check_int(deque_mt_shift_wait(d, &out, 0), ETIMEDOUT);
+	start = now_ms();
+	failures += check_int(deque_mt_pop_wait(d, &out, 20), ETIMEDOUT);
+	failures += check_int_m(now_ms() - start >= 19, 1, "waited");
+
+	/* a stored NULL is not the same as empty */
+	failures += check_int(deque_mt_push_wait(d, NULL, 0), 0);
+	out = d;
+	failures += check_int(deque_mt_shift_wait(d, &out, 0), 0);
+	failures += check_ptr(out, NULL);
+
+	/* bounded */
+	deque_mt_set_max_size(d, 2);
+	failures += check_int(deque_mt_push_wait(d, d, 0), 0);
+	failures += check_int(deque_mt_unshift_wait(d, d, 0), 0);
+	failures += check_int(deque_mt_push_wait(d, d, 0), ETIMEDOUT);
+	failures += check_int(deque_mt_unshift_wait(d, d, 5), ETIMEDOUT);
+	failures += check_size_t(deque_mt_size(d), 2);
+	deque_mt_set_max_size(d, 0);
+	failures += check_int(deque_mt_push_wait(d, d, 0), 0);
+
+	deque_mt_free(d);
+
+	return failures;
+}
+
+#define Blocking_max 8
+#define Per_thread 20000
+
+struct blocking_thread {
+	struct deque_mt *d;
+	size_t id;
+	size_t errors;
+	size_t sum;
+};
+
+static void *blocking_producer(void *arg)
+{
+	struct blocking_thread *t = (struct blocking_thread *)arg;
+	size_t i;
+	int rv;
+
+	for (i = 1; i <= Per_thread; ++i) {
+		if (i % 2) {
+			rv = deque_mt_push_wait(t->d, (void *)(uintptr_t)i, -1);
+		} else {
+			rv = deque_mt_unshift_wait(t->d, (void *)(uintptr_t)i,
+						   -1);
+		}
+		if (rv) {
+			++t->errors;
+		}
+	}
+	return NULL;
+}
+
+static void *blocking_consumer(void *arg)
+{
+	struct blocking_thread *t = (struct blocking_thread *)arg;
+	void *out = NULL;
+	size_t i;
+	int rv;
+
+	for (i = 0; i < Per_thread; ++i) {
+		if ((i + t->id) % 2) {
+			rv = deque_mt_shift_wait(t->d, &out, -1);
+		} else {
+			rv = deque_mt_pop_wait(t->d, &out, -1);
+		}
+		if (rv || deque_mt_size(t->d) > Blocking_max) {
+			++t->errors;
+		}
+		t->sum += (uintptr_t)out;
+	}
+	return NULL;
+}
+
+/* producers block while full, consumers block while empty */
+unsigned test_deque_mt_blocking(void)
+{
+	unsigned failures = 0;
+	struct blocking_thread producers[Producers];
+	struct blocking_thread consumers[Producers];
+	pthread_t threads[2 * Producers];
+	struct deque_mt *d = NULL;
+	size_t sum = 0;
+	size_t expect, i;
+
+	d = deque_mt_new();
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	deque_mt_set_max_size(d, Blocking_max);
+
+	for (i = 0; i < Producers; ++i) {
+		eembed_memset(&producers[i], 0x00,
+			      sizeof(struct blocking_thread));
+		producers[i].d = d;
+		producers[i].id = i;
+		consumers[i] = producers[i];
+		pthread_create(&threads[i], NULL, blocking_consumer,
+			       &consumers[i]);
+		pthread_create(&threads[Producers + i], NULL,
+			       blocking_producer, &producers[i]);
+	}
+	for (i = 0; i < 2 * Producers; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+
+	for (i = 0; i < Producers; ++i) {
+		failures += check_size_t_m(producers[i].errors, 0, "push");
+		failures += check_size_t_m(consumers[i].errors, 0, "shift");
+		sum += consumers[i].sum;
+	}
+	expect = Producers * ((((size_t)Per_thread) * (Per_thread + 1)) / 2);
+	failures += check_size_t_m(sum, expect, "sum");
+	failures += check_size_t(deque_mt_size(d), 0);
+
+	deque_mt_free(d);
+
+	return failures;
+}
+
+unsigned test_deque_mt(void)
+{
+	unsigned failures = 0;
+
+	failures += test_deque_mt_single_thread();
+	failures += test_deque_mt_stress();
+	failures += test_deque_mt_wait_timeout();
+	failures += test_deque_mt_blocking();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_mt)
@@ -23,4 +23,66 @@ unsigned test_deque_new()
 	return failures;
 }
 
-ECHECK_TEST_MAIN(test_deque_new)
+unsigned test_deque_new_one_allocation(unsigned options)
+{
+	unsigned failures = 0;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct deque *d;
+	struct deque s;
+	size_t i, block, wrong = 0;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+
+	/* the data_space follows the struct, in the same allocation */
+	d = deque_init_options(NULL, NULL, 0, &wrap, options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_unsigned_int_m(ctx.allocs, 1, "allocs");
+	failures += check_ptr(d->data_space, (void **)(d + 1));
+	/* the block is Deque_default_len slots, but has at least 4 free */
+	block = Deque_default_len * sizeof(void *);
+	if (block < sizeof(struct deque) + (4 * sizeof(void *))) {
+		block = sizeof(struct deque) + (4 * sizeof(void *));
+	}
+	failures += check_size_t((deque_capacity(d) * sizeof(void *))
+				 + sizeof(struct deque), block);
+
+	/* which grows out of line, the struct stays */
+	for (i = 0; i < 3 * Deque_default_len; ++i) {
+		deque_push(d, (void *)(uintptr_t)(i + 1));
+	}
+	failures += check_int(d->data_space != (void **)(d + 1) ? 1 : 0, 1);
+	for (i = 0; i < 3 * Deque_default_len; ++i) {
+		wrong += (deque_shift(d) != (void *)(uintptr_t)(i + 1));
+	}
+	failures += check_size_t(wrong, 0);
+
+	deque_free(d);
+	failures += check_unsigned_int_m(ctx.frees, ctx.allocs, "frees,allocs");
+
+	/* a struct supplied by the caller can not hold the data_space */
+	failures += check_ptr(deque_init(&s, NULL, 0, &wrap), &s);
+	failures += check_int(s.flags.data_space_needs_free, 1);
+	deque_free(&s);
+	failures += check_unsigned_int_m(ctx.frees, ctx.allocs, "frees,allocs");
+
+	return failures;
+}
+
+unsigned test_deque_new_all(void)
+{
+	unsigned failures = 0;
+
+	failures += test_deque_new();
+	failures += test_deque_new_one_allocation(0);
+	failures += test_deque_new_one_allocation(Deque_option_ring);
+	failures += test_deque_new_one_allocation(Deque_option_no_scrub);
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_new_all)
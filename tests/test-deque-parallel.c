@@ -0,0 +1,153 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-deque-parallel.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-parallel.h"
+#include "echeck.h"
+
+#include <stdlib.h>
+
+#define Items (100 * 1000)
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+struct visit_context {
+	/* updated with __atomic */
+	unsigned char *seen;
+	size_t visits;
+	/* if an index is in halt_at, func returns its position plus one */
+	size_t halt_at[3];
+};
+
+static int visit(struct deque *d, void *each, void *context)
+{
+	struct visit_context *ctx = (struct visit_context *)context;
+	size_t i = ((uintptr_t)each) - 1;
+	size_t j;
+
+	(void)d;
+	__atomic_add_fetch(&ctx->seen[i], 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&ctx->visits, 1, __ATOMIC_RELAXED);
+	for (j = 0; j < 3; ++j) {
+		if (i == ctx->halt_at[j]) {
+			return (int)(j + 1);
+		}
+	}
+	return 0;
+}
+
+static void visit_reset(struct visit_context *ctx, size_t n)
+{
+	eembed_memset(ctx->seen, 0x00, n);
+	ctx->visits = 0;
+	ctx->halt_at[0] = Deque_not_found;
+	ctx->halt_at[1] = Deque_not_found;
+	ctx->halt_at[2] = Deque_not_found;
+}
+
+unsigned test_parallel_each_once(struct deque *d, struct visit_context *ctx,
+				 size_t nthreads)
+{
+	unsigned failures = 0;
+	size_t n = deque_size(d);
+	size_t i, wrong = 0;
+
+	visit_reset(ctx, n);
+	failures += check_int(deque_parallel_for_each(d, visit, ctx, nthreads),
+			      0);
+	failures += check_size_t(ctx->visits, n);
+	for (i = 0; i < n; ++i) {
+		wrong += (ctx->seen[i] != 1);
+	}
+	failures += check_size_t(wrong, 0);
+
+	return failures;
+}
+
+unsigned test_parallel_halt(struct deque *d, struct visit_context *ctx,
+			    size_t nthreads)
+{
+	unsigned failures = 0;
+	size_t n = deque_size(d);
+	size_t i, before = 0;
+
+	/* the lowest index wins, whichever thread found it first */
+	visit_reset(ctx, n);
+	ctx->halt_at[0] = n - 1;
+	ctx->halt_at[1] = n / 2;
+	ctx->halt_at[2] = n / 3;
+	failures += check_int(deque_parallel_for_each(d, visit, ctx, nthreads),
+			      3);
+	for (i = 0; i <= n / 3; ++i) {
+		before += ctx->seen[i];
+	}
+	failures += check_size_t(before, (n / 3) + 1);
+
+	visit_reset(ctx, n);
+	ctx->halt_at[1] = 0;
+	failures += check_int(deque_parallel_for_each(d, visit, ctx, nthreads),
+			      2);
+
+	visit_reset(ctx, n);
+	ctx->halt_at[0] = n - 1;
+	failures += check_int(deque_parallel_for_each(d, visit, ctx, nthreads),
+			      1);
+	failures += check_size_t(ctx->visits, n);
+
+	return failures;
+}
+
+unsigned test_deque_parallel(void)
+{
+	unsigned failures = 0;
+	struct visit_context ctx;
+	struct deque *d = NULL;
+	size_t i, nthreads[] = { 0, 1, 2, 3, 8, 1000 };
+	unsigned options[] = { 0, Deque_option_ring };
+	size_t o, t;
+
+	ctx.seen = (unsigned char *)calloc(Items, 1);
+	if (!ctx.seen) {
+		check_int(ctx.seen != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	for (o = 0; o < 2; ++o) {
+		d = deque_init_options(NULL, NULL, 0, NULL, options[o]);
+		if (!d) {
+			check_int(d != NULL ? 1 : 0, 1);
+			free(ctx.seen);
+			return 1;
+		}
+
+		/* empty, and smaller than a chunk */
+		failures += test_parallel_each_once(d, &ctx, 4);
+		for (i = 0; i < 10; ++i) {
+			deque_push(d, item(i));
+		}
+		failures += test_parallel_each_once(d, &ctx, 4);
+		failures += test_parallel_halt(d, &ctx, 4);
+
+		/* from both ends, thus a ring is wrapped */
+		deque_clear(d);
+		for (i = 0; i < Items; ++i) {
+			if (i < Items / 4) {
+				deque_unshift(d, item((Items / 4) - (i + 1)));
+			} else {
+				deque_push(d, item(i));
+			}
+		}
+		for (t = 0; t < sizeof(nthreads) / sizeof(size_t); ++t) {
+			failures += test_parallel_each_once(d, &ctx,
+							    nthreads[t]);
+			failures += test_parallel_halt(d, &ctx, nthreads[t]);
+		}
+		deque_free(d);
+	}
+
+	free(ctx.seen);
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_parallel)
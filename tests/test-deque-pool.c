@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-deque-pool.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-pool.h"
+#include "echeck.h"
+
+#if Deque_threads
+#include <pthread.h>
+#endif
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+unsigned test_pool_reuse(unsigned options)
+{
+	unsigned failures = 0;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct deque_pool *pool = NULL;
+	struct deque *d[10];
+	unsigned long allocs = 0;
+	size_t i, j;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+	pool = deque_pool_create(&wrap, 16, options);
+	if (!pool) {
+		check_int(pool != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	for (j = 0; j < 100; ++j) {
+		for (i = 0; i < 10; ++i) {
+			d[i] = deque_pool_get(pool);
+			if (!d[i]) {
+				check_int(d[i] != NULL ? 1 : 0, 1);
+				return 1;
+			}
+			failures += check_size_t(deque_size(d[i]), 0);
+			failures += check_size_t(deque_capacity(d[i]), 16);
+			failures += check_int(d[i]->flags.ring,
+					      (options & Deque_option_ring)
+					      ? 1 : 0);
+			deque_push(d[i], item(i));
+			deque_unshift(d[i], item(j));
+		}
+		for (i = 0; i < 10; ++i) {
+			failures += check_ptr(deque_pop(d[i]), item(i));
+			deque_pool_put(pool, d[i]);
+		}
+		if (j == 0) {
+			allocs = ctx.allocs;
+		}
+	}
+	/* after the first round, nothing more was allocated */
+	failures += check_unsigned_int_m(ctx.allocs, allocs, "allocs");
+
+	/* a grown data_space is freed when put, the block is kept */
+	d[0] = deque_pool_get(pool);
+	for (i = 0; i < 100; ++i) {
+		deque_push(d[0], item(i));
+	}
+	failures += check_int(deque_capacity(d[0]) > 16 ? 1 : 0, 1);
+	deque_pool_put(pool, d[0]);
+	d[0] = deque_pool_get(pool);
+	failures += check_size_t(deque_capacity(d[0]), 16);
+	deque_pool_put(pool, d[0]);
+	deque_pool_put(pool, NULL);
+
+	deque_pool_destroy(pool);
+	deque_pool_destroy(NULL);
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+
+	return failures;
+}
+
+unsigned test_pool_out_of_memory(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct deque_pool *pool = NULL;
+	struct deque *d = NULL;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+	ctx.attempts_to_fail_bitmask = 0x01;
+	failures += check_ptr(deque_pool_create(&wrap, 0, 0), NULL);
+
+	ctx.attempts = 0;
+	ctx.attempts_to_fail_bitmask = 0;
+	pool = deque_pool_create(&wrap, 0, 0);
+	if (!pool) {
+		check_int(pool != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	/* the first get may also create the cache of this thread */
+	ctx.attempts = 0;
+	ctx.attempts_to_fail_bitmask = 0x03;
+	failures += check_ptr(deque_pool_get(pool), NULL);
+	ctx.attempts_to_fail_bitmask = 0;
+	d = deque_pool_get(pool);
+	failures += check_size_t(deque_capacity(d), Deque_default_len);
+	deque_pool_put(pool, d);
+
+	deque_pool_destroy(pool);
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+
+	return failures;
+}
+
+#if Deque_threads
+#define Threads 4
+#define Rounds 2000
+
+struct pool_worker {
+	pthread_t thread;
+	struct deque_pool *pool;
+	size_t id;
+	size_t wrong;
+};
+
+static void *pool_worker_run(void *arg)
+{
+	struct pool_worker *w = (struct pool_worker *)arg;
+	struct deque *d[Deque_pool_cache_len * 2];
+	size_t i, j, n;
+
+	for (j = 0; j < Rounds; ++j) {
+		/* more than a cache, thus also through the shared list */
+		n = 1 + ((j * 7) % (Deque_pool_cache_len * 2));
+		for (i = 0; i < n; ++i) {
+			d[i] = deque_pool_get(w->pool);
+			if (!d[i]) {
+				++w->wrong;
+				return NULL;
+			}
+			w->wrong += (deque_size(d[i]) != 0);
+			deque_push(d[i], item(w->id));
+		}
+		for (i = 0; i < n; ++i) {
+			w->wrong += (deque_shift(d[i]) != item(w->id));
+			deque_pool_put(w->pool, d[i]);
+		}
+	}
+	return NULL;
+}
+
+unsigned test_pool_threads(void)
+{
+	unsigned failures = 0;
+	struct pool_worker w[Threads];
+	struct deque_pool *pool = deque_pool_create(NULL, 0, 0);
+	struct deque *d = NULL;
+	size_t i;
+
+	if (!pool) {
+		check_int(pool != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	for (i = 0; i < Threads; ++i) {
+		w[i].pool = pool;
+		w[i].id = i;
+		w[i].wrong = 0;
+		pthread_create(&w[i].thread, NULL, pool_worker_run, &w[i]);
+	}
+	for (i = 0; i < Threads; ++i) {
+		pthread_join(w[i].thread, NULL);
+		failures += check_size_t(w[i].wrong, 0);
+	}
+
+	/* the exited threads gave their caches back */
+	d = deque_pool_get(pool);
+	failures += check_size_t(deque_size(d), 0);
+	deque_pool_put(pool, d);
+
+	deque_pool_destroy(pool);
+	return failures;
+}
+#endif
+
+unsigned test_deque_pool(void)
+{
+	unsigned failures = 0;
+
+	failures += test_pool_reuse(0);
+	failures += test_pool_reuse(Deque_option_ring);
+	failures += test_pool_reuse(Deque_option_secure_scrub);
+	failures += test_pool_out_of_memory();
+#if Deque_threads
+	failures += test_pool_threads();
+#endif
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_pool)
@@ -0,0 +1,221 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-deque-seg.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-seg.h"
+#include "echeck.h"
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+int sum_each(struct deque_seg *d, void *each, void *context)
+{
+	uintptr_t *sum = (uintptr_t *)context;
+	(void)d;
+	*sum += (uintptr_t)each;
+	return 0;
+}
+
+int stop_at_three(struct deque_seg *d, void *each, void *context)
+{
+	(void)d;
+	(void)context;
+	return each == item(2) ? 3 : 0;
+}
+
+unsigned test_deque_seg_basic(void)
+{
+	unsigned failures = 0;
+	struct deque_seg seg;
+	struct deque_seg *d;
+	uintptr_t sum = 0;
+	void **slot = NULL;
+	size_t i;
+
+	/* tiny blocks, to cross many block boundaries */
+	d = deque_seg_init(&seg, 3, NULL);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_size_t_m(d->block_mask + 1, 4, "power of two");
+	failures += check_ptr(deque_seg_pop(d), NULL);
+	failures += check_ptr(deque_seg_shift(d), NULL);
+	failures += check_ptr(deque_seg_peek_top(d, 0), NULL);
+
+	for (i = 0; i < 100; ++i) {
+		deque_seg_push(d, item(i));
+	}
+	failures += check_size_t(deque_seg_size(d), 100);
+	failures += check_ptr(deque_seg_peek_bottom(d, 0), item(0));
+	failures += check_ptr(deque_seg_peek_bottom(d, 37), item(37));
+	failures += check_ptr(deque_seg_peek_top(d, 0), item(99));
+	failures += check_ptr(deque_seg_peek_top(d, 9), item(90));
+	failures += check_ptr(deque_seg_peek_top(d, 100), NULL);
+
+	/* the slots stay put while the deque grows at both ends */
+	slot = deque_seg_slot(d, 50);
+	for (i = 0; i < 1000; ++i) {
+		deque_seg_push(d, item(i));
+		deque_seg_unshift(d, item(i));
+	}
+	failures += check_ptr(deque_seg_slot(d, 1050), slot);
+	failures += check_ptr(*slot, item(50));
+	failures += check_ptr(deque_seg_slot(d, 2100), NULL);
+
+	deque_seg_clear(d);
+	failures += check_size_t(deque_seg_size(d), 0);
+	for (i = 0; i < 10; ++i) {
+		deque_seg_unshift(d, item(9 - i));
+	}
+	failures += check_int(deque_seg_for_each(d, sum_each, &sum), 0);
+	failures += check_size_t((size_t)sum, 55);
+	failures += check_int(deque_seg_for_each(d, stop_at_three, NULL), 3);
+
+	for (i = 0; i < 10; ++i) {
+		failures += check_ptr(deque_seg_shift(d), item(i));
+	}
+	failures += check_ptr(deque_seg_shift(d), NULL);
+
+	deque_seg_free(d);
+
+	return failures;
+}
+
+/* the same random operations on a struct deque and a deque_seg */
+unsigned test_deque_seg_compare(size_t block_len)
+{
+	unsigned failures = 0;
+	struct deque *expect = deque_new();
+	struct deque_seg *d = deque_seg_init(NULL, block_len, NULL);
+	uint32_t x = 2463534242UL;
+	size_t i, j, n = 0;
+
+	if (!expect || !d) {
+		check_int((expect && d) ? 1 : 0, 1);
+		deque_free(expect);
+		deque_seg_free(d);
+		return 1;
+	}
+
+	for (i = 0; i < 20000 && !failures; ++i) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		/* a bias toward adding, so the size wanders upward */
+		switch (x % 7) {
+		case 0:
+		case 1:
+			deque_push(expect, item(n));
+			deque_seg_push(d, item(n++));
+			break;
+		case 2:
+		case 3:
+			deque_unshift(expect, item(n));
+			deque_seg_unshift(d, item(n++));
+			break;
+		case 4:
+			failures += check_ptr(deque_seg_pop(d),
+					      deque_pop(expect));
+			break;
+		case 5:
+			failures += check_ptr(deque_seg_shift(d),
+					      deque_shift(expect));
+			break;
+		default:
+			if (deque_size(expect)) {
+				j = (x >> 8) % deque_size(expect);
+				failures +=
+				    check_ptr(deque_seg_peek_bottom(d, j),
+					      deque_peek_bottom(expect, j));
+				failures +=
+				    check_ptr(deque_seg_peek_top(d, j),
+					      deque_peek_top(expect, j));
+			}
+			break;
+		}
+		failures += check_size_t(deque_seg_size(d), deque_size(expect));
+	}
+
+	while (deque_size(expect) && !failures) {
+		failures += check_ptr(deque_seg_pop(d), deque_pop(expect));
+	}
+	failures += check_size_t(deque_seg_size(d), 0);
+
+	deque_seg_free(d);
+	deque_free(expect);
+
+	return failures;
+}
+
+unsigned test_deque_seg_recycle(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct deque_seg *d;
+	unsigned long allocs;
+	void *top;
+	size_t i;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+
+	d = deque_seg_init(NULL, 4, &wrap);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	/* the first block, starting in the middle, and one more */
+	for (i = 0; i < 3; ++i) {
+		deque_seg_push(d, item(i));
+	}
+	allocs = ctx.allocs;
+
+	/* back and forth across the block boundary, and as a queue */
+	for (i = 0; i < 100; ++i) {
+		deque_seg_pop(d);
+		deque_seg_push(d, item(i));
+		deque_seg_push(d, item(i));
+		deque_seg_shift(d);
+	}
+	failures += check_unsigned_int_m(ctx.allocs - allocs, 0, "recycled");
+
+	/* a failed block allocation leaves the deque as it was */
+	while (d->spare || (d->first_pos + deque_seg_size(d)) & d->block_mask) {
+		deque_seg_push(d, item(0));
+	}
+	i = deque_seg_size(d);
+	top = deque_seg_peek_top(d, 0);
+	ctx.attempts = 0;
+	ctx.attempts_to_fail_bitmask = 0x01;
+	failures += check_ptr(deque_seg_push(d, item(1)), NULL);
+	failures += check_size_t(deque_seg_size(d), i);
+	failures += check_ptr(deque_seg_peek_top(d, 0), top);
+	ctx.attempts_to_fail_bitmask = 0;
+	failures += check_ptr(deque_seg_push(d, item(1)), d);
+	failures += check_ptr(deque_seg_peek_top(d, 0), item(1));
+
+	deque_seg_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+unsigned test_deque_seg(void)
+{
+	unsigned failures = 0;
+
+	failures += test_deque_seg_basic();
+	failures += test_deque_seg_compare(1);
+	failures += test_deque_seg_compare(4);
+	failures += test_deque_seg_compare(0);
+	failures += test_deque_seg_recycle();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_seg)
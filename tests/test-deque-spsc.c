@@ -0,0 +1,124 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-deque-spsc.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-spsc.h"
+#include "echeck.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#define Total 500000
+
+static void *producer(void *arg)
+{
+	struct deque_spsc *d = (struct deque_spsc *)arg;
+	size_t i;
+
+	for (i = 1; i <= Total; ++i) {
+		while (!deque_spsc_push(d, (void *)(uintptr_t)i)) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+unsigned test_deque_spsc_threads(void)
+{
+	unsigned failures = 0;
+	unsigned char bytes[1024];
+	struct deque_spsc *d = NULL;
+	pthread_t thread;
+	size_t i, out_of_order = 0;
+	void *data;
+
+	d = deque_spsc_new_no_allocator(bytes, sizeof(bytes));
+	if (!d) {
+		check_int(0, 1);
+		return 1;
+	}
+
+	pthread_create(&thread, NULL, producer, d);
+	for (i = 1; i <= Total; ++i) {
+		while ((data = deque_spsc_shift(d)) == NULL) {
+			sched_yield();
+		}
+		if (data != (void *)(uintptr_t)i) {
+			++out_of_order;
+		}
+	}
+	pthread_join(thread, NULL);
+
+	failures += check_size_t(out_of_order, 0);
+	failures += check_size_t(deque_spsc_size(d), 0);
+	failures += check_ptr(deque_spsc_shift(d), NULL);
+
+	return failures;
+}
+
+unsigned test_deque_spsc_single_thread(void)
+{
+	unsigned failures = 0;
+	unsigned char bytes[1024];
+	struct deque_spsc *d = NULL;
+	size_t i, len, round;
+
+	failures += check_ptr(deque_spsc_new_no_allocator(NULL, 1024), NULL);
+	failures += check_ptr(deque_spsc_new_no_allocator(bytes, 8), NULL);
+
+	d = deque_spsc_new_no_allocator(bytes, sizeof(bytes));
+	if (!d) {
+		check_int(0, 1);
+		return 1;
+	}
+	len = deque_spsc_capacity(d);
+	failures += check_int_m(len >= 2, 1, "capacity");
+	failures += check_size_t_m(len & (len - 1), 0, "power of two");
+	failures += check_int_m(((unsigned char *)
+				 (d->consumer.c.data_space + len))
+				<= (bytes + sizeof(bytes)), 1, "fits");
+	failures += check_ptr_m(d->producer.p.data_space,
+				d->consumer.c.data_space, "data_space");
+	failures += check_size_t_m(d->producer.p.mask, d->consumer.c.mask,
+				   "mask");
+
+	failures += check_ptr(deque_spsc_shift(d), NULL);
+
+	/* wrap around a few times */
+	for (round = 0; round < 3; ++round) {
+		for (i = 0; i < len; ++i) {
+			failures += check_ptr(deque_spsc_push(d,
+							      (void *)(uintptr_t)
+							      (i + 1)), d);
+		}
+		failures += check_size_t(deque_spsc_size(d), len);
+		failures += check_ptr_m(deque_spsc_push(d, d), NULL, "full");
+
+		for (i = 0; i < len / 2; ++i) {
+			failures += check_ptr(deque_spsc_shift(d),
+					      (void *)(uintptr_t)(i + 1));
+		}
+		failures += check_ptr(deque_spsc_push(d, d), d);
+		for (i = len / 2; i < len; ++i) {
+			failures += check_ptr(deque_spsc_shift(d),
+					      (void *)(uintptr_t)(i + 1));
+		}
+		failures += check_ptr(deque_spsc_shift(d), d);
+		failures += check_ptr(deque_spsc_shift(d), NULL);
+		failures += check_size_t(deque_spsc_size(d), 0);
+	}
+
+	return failures;
+}
+
+unsigned test_deque_spsc(void)
+{
+	unsigned failures = 0;
+
+	failures += test_deque_spsc_single_thread();
+	failures += test_deque_spsc_threads();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_spsc)
@@ -0,0 +1,206 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-deque-typed.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-typed.h"
+#include "echeck.h"
+
+struct point {
+	double x;
+	double y;
+	int tag;
+};
+
+Deque_define(deque_size_t, size_t);
+Deque_define(deque_point, struct point);
+
+int sum_each(struct deque_size_t *d, size_t *each, void *context)
+{
+	(void)d;
+	*(size_t *)context += *each;
+	return 0;
+}
+
+int stop_at_tag(struct deque_point *d, struct point *each, void *context)
+{
+	(void)d;
+	return (each->tag == *(int *)context) ? each->tag : 0;
+}
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+/* the same random operations on a struct deque and a typed deque */
+unsigned test_deque_typed_compare(struct eembed_allocator *ea)
+{
+	unsigned failures = 0;
+	struct deque *expect = deque_new();
+	struct deque_size_t typed;
+	struct deque_size_t *d = deque_size_t_init(&typed, 4, ea);
+	uint32_t x = 2463534242UL;
+	void *e = NULL;
+	size_t i, j, n = 0, out = 0, sum = 0, expect_sum = 0;
+
+	if (!expect || !d) {
+		check_int((expect && d) ? 1 : 0, 1);
+		deque_free(expect);
+		deque_size_t_free(d);
+		return 1;
+	}
+
+	for (i = 0; i < 20000 && !failures; ++i) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		switch (x % 7) {
+		case 0:
+		case 1:
+			deque_push(expect, item(n));
+			failures += check_ptr(deque_size_t_push(d, n++), d);
+			break;
+		case 2:
+		case 3:
+			deque_unshift(expect, item(n));
+			failures += check_ptr(deque_size_t_unshift(d, n++), d);
+			break;
+		case 4:
+			out = (size_t)-1;
+			deque_size_t_pop(d, &out);
+			failures += check_ptr(item(out), deque_pop(expect));
+			break;
+		case 5:
+			out = (size_t)-1;
+			deque_size_t_shift(d, &out);
+			failures += check_ptr(item(out), deque_shift(expect));
+			break;
+		default:
+			if (deque_size(expect)) {
+				j = (x >> 8) % deque_size(expect);
+				out = *deque_size_t_peek_bottom(d, j);
+				e = deque_peek_bottom(expect, j);
+				failures += check_ptr(item(out), e);
+				out = *deque_size_t_peek_top(d, j);
+				e = deque_peek_top(expect, j);
+				failures += check_ptr(item(out), e);
+			}
+			break;
+		}
+		failures +=
+		    check_size_t(deque_size_t_size(d), deque_size(expect));
+	}
+
+	failures += check_ptr(deque_size_t_peek_top(d, deque_size(expect)),
+			      NULL);
+	for (i = 0; i < deque_size(expect); ++i) {
+		expect_sum += (uintptr_t)deque_peek_bottom(expect, i) - 1;
+	}
+	failures += check_int(deque_size_t_for_each(d, sum_each, &sum), 0);
+	failures += check_size_t(sum, expect_sum);
+
+	deque_size_t_clear(d);
+	failures += check_size_t(deque_size_t_size(d), 0);
+	failures += check_ptr(deque_size_t_pop(d, &out), NULL);
+	failures += check_ptr(deque_size_t_shift(d, NULL), NULL);
+
+	deque_size_t_free(d);
+	deque_free(expect);
+
+	return failures;
+}
+
+unsigned test_deque_typed_struct(void)
+{
+	unsigned failures = 0;
+	struct deque_point *d = deque_point_new(NULL);
+	struct point p;
+	int i, tag = 7;
+
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	for (i = 0; i < 100; ++i) {
+		p.x = i;
+		p.y = -i;
+		p.tag = i;
+		if (i % 2) {
+			deque_point_push(d, p);
+		} else {
+			deque_point_unshift(d, p);
+		}
+	}
+	failures += check_size_t(deque_point_size(d), 100);
+	failures += check_int(deque_point_peek_bottom(d, 0)->tag, 98);
+	failures += check_int(deque_point_peek_top(d, 0)->tag, 99);
+	failures += check_int((int)deque_point_peek_top(d, 0)->y, -99);
+	failures += check_int(deque_point_for_each(d, stop_at_tag, &tag), 7);
+
+	failures += check_ptr(deque_point_shift(d, &p), d);
+	failures += check_int(p.tag, 98);
+	failures += check_ptr(deque_point_pop(d, &p), d);
+	failures += check_int(p.tag, 99);
+
+	deque_point_free(d);
+
+	return failures;
+}
+
+unsigned test_deque_typed_out_of_memory(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct deque_size_t *d = NULL;
+	size_t i, len;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+
+	d = deque_size_t_new(&wrap);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	/* unshift grows only once full, push may grow before then */
+	len = deque_size_t_capacity(d);
+	for (i = 0; i < len; ++i) {
+		deque_size_t_unshift(d, i);
+	}
+	failures += check_size_t(deque_size_t_capacity(d), len);
+
+	ctx.attempts = 0;
+	ctx.attempts_to_fail_bitmask = 0x01;
+	failures += check_ptr(deque_size_t_unshift(d, len), NULL);
+	failures += check_size_t(deque_size_t_size(d), len);
+	failures += check_size_t(*deque_size_t_peek_bottom(d, 0), len - 1);
+
+	ctx.attempts_to_fail_bitmask = 0;
+	failures += check_ptr(deque_size_t_unshift(d, len), d);
+	failures += check_size_t(*deque_size_t_peek_bottom(d, 0), len);
+	failures += check_int_m(deque_size_t_capacity(d) > len, 1, "grew");
+
+	deque_size_t_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+
+	return failures;
+}
+
+unsigned test_deque_typed(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator no_realloc;
+
+	/* the same allocator, but growing by malloc, copy, and free */
+	no_realloc = *eembed_global_allocator;
+	no_realloc.realloc = NULL;
+
+	failures += test_deque_typed_compare(NULL);
+	failures += test_deque_typed_compare(&no_realloc);
+	failures += test_deque_typed_struct();
+	failures += test_deque_typed_out_of_memory();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_typed)
@@ -0,0 +1,176 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-deque-ws.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque-ws.h"
+#include "echeck.h"
+
+#include <pthread.h>
+
+#define Thieves 4
+#define Total 200000
+
+struct steal_context {
+	struct deque_ws *d;
+	size_t taken;		/* shared, updated with __atomic */
+	unsigned char *seen;
+};
+
+struct steal_thread {
+	struct steal_context *ctx;
+	size_t errors;
+};
+
+static size_t take(struct steal_context *ctx, uintptr_t v)
+{
+	if (!v) {
+		return 0;
+	}
+	__atomic_fetch_add(&ctx->taken, 1, __ATOMIC_RELEASE);
+	if (v > Total
+	    || __atomic_fetch_add(&ctx->seen[v - 1], 1, __ATOMIC_RELAXED)) {
+		return 1;
+	}
+	return 0;
+}
+
+static void *thief(void *arg)
+{
+	struct steal_thread *t = (struct steal_thread *)arg;
+	struct steal_context *ctx = t->ctx;
+
+	while (__atomic_load_n(&ctx->taken, __ATOMIC_ACQUIRE) < Total) {
+		t->errors += take(ctx, (uintptr_t)deque_ws_shift(ctx->d));
+	}
+	return NULL;
+}
+
+unsigned test_deque_ws_stealing(void)
+{
+	unsigned failures = 0;
+	struct steal_context ctx;
+	struct steal_thread thieves[Thieves];
+	pthread_t threads[Thieves];
+	struct eembed_allocator *ea = eembed_global_allocator;
+	size_t i, errors = 0;
+
+	eembed_memset(&ctx, 0x00, sizeof(struct steal_context));
+	ctx.seen = (unsigned char *)ea->calloc(ea, Total, 1);
+	/* start small, so that it grows while being stolen from */
+	ctx.d = deque_ws_init(NULL, 4, NULL);
+	if (!ctx.seen || !ctx.d) {
+		check_int(0, 1);
+		return 1;
+	}
+
+	for (i = 0; i < Thieves; ++i) {
+		thieves[i].ctx = &ctx;
+		thieves[i].errors = 0;
+		pthread_create(&threads[i], NULL, thief, &thieves[i]);
+	}
+
+	/* the owner pushes, and pops back some of what it pushed */
+	for (i = 1; i <= Total; ++i) {
+		if (!deque_ws_push(ctx.d, (void *)(uintptr_t)i)) {
+			++errors;
+		}
+		if ((i % 3) == 0) {
+			errors += take(&ctx, (uintptr_t)deque_ws_pop(ctx.d));
+		}
+	}
+	while (__atomic_load_n(&ctx.taken, __ATOMIC_ACQUIRE) < Total) {
+		errors += take(&ctx, (uintptr_t)deque_ws_pop(ctx.d));
+	}
+
+	for (i = 0; i < Thieves; ++i) {
+		pthread_join(threads[i], NULL);
+		failures += check_size_t_m(thieves[i].errors, 0, "thief");
+	}
+	failures += check_size_t_m(errors, 0, "owner");
+	failures += check_size_t(ctx.taken, Total);
+	for (i = 0; i < Total; ++i) {
+		if (ctx.seen[i] != 1) {
+			failures += check_int_m(ctx.seen[i], 1, "seen");
+			break;
+		}
+	}
+	failures += check_size_t(deque_ws_size(ctx.d), 0);
+	failures += check_ptr(deque_ws_pop(ctx.d), NULL);
+	failures += check_ptr(deque_ws_shift(ctx.d), NULL);
+
+	deque_ws_free(ctx.d);
+	ea->free(ea, ctx.seen);
+
+	return failures;
+}
+
+unsigned test_deque_ws_single_thread(void)
+{
+	unsigned failures = 0;
+	struct deque_ws *d = NULL;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator wrap;
+	struct eembed_allocator *real = eembed_global_allocator;
+	struct eembed_log *elog = eembed_err_log;
+	size_t i;
+
+	echeck_err_injecting_allocator_init(&wrap, real, &ctx, elog);
+
+	d = deque_ws_init(NULL, 3, &wrap);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_ptr(deque_ws_pop(d), NULL);
+	failures += check_ptr(deque_ws_shift(d), NULL);
+
+	for (i = 1; i <= 4; ++i) {
+		failures +=
+		    check_ptr(deque_ws_push(d, (void *)(uintptr_t)i), d);
+	}
+
+	/* a failed allocation leaves the deque as it was */
+	ctx.attempts_to_fail_bitmask = ~0UL;
+	failures += check_ptr(deque_ws_push(d, NULL), NULL);
+	ctx.attempts_to_fail_bitmask = 0;
+	failures += check_size_t(deque_ws_size(d), 4);
+
+	for (i = 5; i <= 10; ++i) {
+		failures +=
+		    check_ptr(deque_ws_push(d, (void *)(uintptr_t)i), d);
+	}
+	failures += check_size_t(deque_ws_size(d), 10);
+
+	/* stack at the top, queue at the bottom */
+	failures += check_ptr(deque_ws_pop(d), (void *)(uintptr_t)10);
+	failures += check_ptr(deque_ws_shift(d), (void *)(uintptr_t)1);
+	failures += check_ptr(deque_ws_pop(d), (void *)(uintptr_t)9);
+	failures += check_ptr(deque_ws_shift(d), (void *)(uintptr_t)2);
+	for (i = 8; i > 2; --i) {
+		failures +=
+		    check_ptr(deque_ws_pop(d), (void *)(uintptr_t)i);
+	}
+	failures += check_size_t(deque_ws_size(d), 0);
+	failures += check_ptr(deque_ws_pop(d), NULL);
+	failures += check_ptr(deque_ws_shift(d), NULL);
+
+	deque_ws_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+unsigned test_deque_ws(void)
+{
+	unsigned failures = 0;
+
+	failures += test_deque_ws_single_thread();
+	failures += test_deque_ws_stealing();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_deque_ws)
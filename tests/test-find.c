@@ -0,0 +1,125 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-find.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+/* the key at every index of deques of many lengths, that is, at every
+   position within and after the blocks which are compared at once */
+unsigned test_find_each_index(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	void *key = item(1000);
+	size_t len, i, j;
+
+	for (len = 0; len < 70 && !failures; ++len) {
+		d = deque_init_options(NULL, NULL, 0, NULL, options);
+		if (!d) {
+			check_int(d != NULL ? 1 : 0, 1);
+			return 1;
+		}
+		for (i = 0; i < len; ++i) {
+			deque_push(d, item(i));
+		}
+		failures += check_size_t(deque_find(d, key), Deque_not_found);
+		failures +=
+		    check_size_t(deque_find_last(d, key), Deque_not_found);
+		failures += check_int(deque_contains(d, key), 0);
+		failures += check_size_t(deque_count(d, key), 0);
+
+		for (i = 0; i < len; ++i) {
+			deque_erase_at(d, i);
+			deque_insert_at(d, i, key);
+			failures += check_size_t(deque_find(d, key), i);
+			failures += check_size_t(deque_find_last(d, key), i);
+			failures += check_int(deque_contains(d, key), 1);
+			failures += check_size_t(deque_count(d, key), 1);
+			deque_erase_at(d, i);
+			deque_insert_at(d, i, item(i));
+		}
+
+		/* every other item is the key */
+		for (i = 0; i < len; i += 2) {
+			deque_erase_at(d, i);
+			deque_insert_at(d, i, key);
+		}
+		j = (len && !((len - 1) % 2)) ? (len - 1) : (len - 2);
+		failures += check_size_t(deque_find(d, key),
+					 len ? 0 : Deque_not_found);
+		failures += check_size_t(deque_find_last(d, key),
+					 len ? j : Deque_not_found);
+		failures += check_size_t(deque_count(d, key), (len + 1) / 2);
+
+		deque_free(d);
+	}
+	return failures;
+}
+
+/* 5 items at the end of data_space, and the rest wrapped to the start */
+unsigned test_find_wrapped(void)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	void **a, **b;
+	size_t a_len, b_len, i;
+
+	d = deque_init_options(NULL, NULL, 64, NULL, Deque_option_ring);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	/* move the front around to slot 0 */
+	while (d->first_pos) {
+		deque_push(d, d);
+		deque_shift(d);
+	}
+	for (i = 0; i < 40; ++i) {
+		deque_push(d, item(i));
+	}
+	for (i = 0; i < 5; ++i) {
+		deque_unshift(d, item(100 + i));
+	}
+	failures += check_int(deque_as_spans(d, &a, &a_len, &b, &b_len), 2);
+	failures += check_size_t(a_len, 5);
+
+	failures += check_size_t(deque_find(d, item(104)), 0);
+	failures += check_size_t(deque_find(d, item(100)), 4);
+	failures += check_size_t(deque_find(d, item(0)), 5);
+	failures += check_size_t(deque_find(d, item(39)), 44);
+
+	/* item(7) both before and after the wrap */
+	deque_erase_at(d, 1);
+	deque_insert_at(d, 1, item(7));
+	deque_erase_at(d, 40);
+	deque_insert_at(d, 40, item(7));
+	failures += check_size_t(deque_find(d, item(7)), 1);
+	failures += check_size_t(deque_find_last(d, item(7)), 40);
+	failures += check_size_t(deque_count(d, item(7)), 3);
+
+	/* NULL may be stored, and found */
+	failures += check_size_t(deque_find(d, NULL), Deque_not_found);
+	deque_push(d, NULL);
+	failures += check_size_t(deque_find(d, NULL), 45);
+	failures += check_int(deque_contains(d, NULL), 1);
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_find(void)
+{
+	unsigned failures = 0;
+
+	failures += test_find_each_index(0);
+	failures += test_find_each_index(Deque_option_ring);
+	failures += test_find_wrapped();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_find)
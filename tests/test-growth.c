@@ -0,0 +1,178 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-growth.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+struct grow_log {
+	size_t calls;
+	size_t min_len;
+	int unshifting;
+};
+
+size_t grow_by_three(struct deque *d, size_t min_len, int unshifting,
+		     void *context)
+{
+	struct grow_log *log = (struct grow_log *)context;
+	(void)d;
+	++log->calls;
+	log->min_len = min_len;
+	log->unshifting = unshifting;
+	return min_len + 3;
+}
+
+/* push until the data_space grows, return the new length */
+size_t push_until_grown(struct deque *d)
+{
+	size_t len = deque_capacity(d);
+
+	while (deque_capacity(d) == len) {
+		if (!deque_push(d, d)) {
+			return 0;
+		}
+	}
+	return deque_capacity(d);
+}
+
+unsigned test_grow_percent(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque_policy policy;
+	struct deque *d;
+
+	eembed_memset(&policy, 0x00, sizeof(struct deque_policy));
+
+	d = deque_init_options(NULL, NULL, 16, NULL, options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	/* default doubles */
+	failures += check_size_t_m(push_until_grown(d), 32, "default");
+
+	deque_set_policy(d, &policy);
+	policy.grow_percent = 150;
+	failures += check_size_t_m(push_until_grown(d), 48, "150%");
+
+	policy.grow_max_step = 10;
+	failures += check_size_t_m(push_until_grown(d), 58, "max step");
+	failures += check_size_t_m(push_until_grown(d), 68, "linear");
+
+	policy.grow_percent = 100;
+	policy.grow_max_step = 0;
+	failures += check_size_t_m(push_until_grown(d), 136, "100% doubles");
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_front_percent(void)
+{
+	unsigned failures = 0;
+	struct deque_policy policy;
+	struct deque *d;
+	size_t i;
+
+	eembed_memset(&policy, 0x00, sizeof(struct deque_policy));
+
+	d = deque_init_options(NULL, NULL, 16, NULL, 0);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	deque_set_policy(d, &policy);
+
+	/* all the spare room goes to the back */
+	policy.front_percent = 0;
+	for (i = 0; i < 16; ++i) {
+		deque_unshift(d, d);
+	}
+	policy.front_percent = 1;
+	failures += check_size_t(push_until_grown(d), 32);
+	failures += check_size_t_m(d->first_pos, 0, "no front");
+
+	/* and the front */
+	policy.front_percent = 100;
+	failures += check_size_t(push_until_grown(d), 64);
+	failures += check_size_t_m(d->end_pos, 64, "all front");
+
+	/* values over 100 are 100 */
+	policy.front_percent = 1000;
+	deque_clear(d);
+	for (i = 0; i < 64; ++i) {
+		deque_unshift(d, d);
+	}
+	failures += check_size_t(push_until_grown(d), 128);
+	failures += check_size_t_m(d->end_pos, 128, "over 100");
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_grow_func(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque_policy policy;
+	struct grow_log log;
+	struct deque *d;
+	size_t len;
+
+	eembed_memset(&policy, 0x00, sizeof(struct deque_policy));
+	eembed_memset(&log, 0x00, sizeof(struct grow_log));
+	policy.grow_func = grow_by_three;
+	policy.grow_context = &log;
+
+	d = deque_init_options(NULL, NULL, 8, NULL, options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	deque_set_policy(d, &policy);
+
+	len = push_until_grown(d);
+	failures += check_size_t(log.calls, 1);
+	failures += check_size_t(len, log.min_len + 3);
+	failures += check_int_m(log.min_len > 8 - 2, 1, "min_len");
+	failures += check_int(log.unshifting, 0);
+
+	while (deque_size(d) < deque_capacity(d)) {
+		deque_unshift(d, d);
+	}
+	deque_unshift(d, NULL);
+	failures += check_size_t(log.calls, 2);
+	failures += check_size_t(log.min_len, len + 1);
+	failures += check_size_t(deque_capacity(d), len + 4);
+	failures += check_int(log.unshifting, 1);
+	failures += check_ptr(deque_peek_bottom(d, 0), NULL);
+
+	/* bulk growth asks for at least what is needed */
+	failures += check_ptr(deque_reserve(d, 0, 100), d);
+	failures += check_size_t(log.calls, 3);
+	failures += check_size_t(log.min_len, deque_size(d) + 100);
+	failures += check_size_t(deque_capacity(d), log.min_len + 3);
+	failures += check_ptr(deque_peek_bottom(d, 0), NULL);
+	failures += check_size_t(deque_size(d), len + 1);
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_growth(void)
+{
+	unsigned failures = 0;
+
+	failures += test_grow_percent(0);
+	failures += test_grow_percent(Deque_option_ring);
+	failures += test_front_percent();
+	failures += test_grow_func(0);
+	failures += test_grow_func(Deque_option_ring);
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_growth)
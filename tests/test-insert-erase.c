@@ -0,0 +1,229 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-insert-erase.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+#define Model_max 1000
+
+/* the expected items, in a plain array */
+struct model {
+	void *items[Model_max];
+	size_t len;
+};
+
+int is_odd(struct deque *d, void *each, void *context)
+{
+	(void)d;
+	++*(size_t *)context;
+	return ((uintptr_t)each) % 2;
+}
+
+int is_multiple(struct deque *d, void *each, void *context)
+{
+	(void)d;
+	return (((uintptr_t)each) % *(uintptr_t *)context) == 0;
+}
+
+unsigned check_model(struct deque *d, struct model *m)
+{
+	unsigned failures = 0;
+	size_t i;
+
+	failures += check_size_t(deque_size(d), m->len);
+	for (i = 0; i < m->len && !failures; ++i) {
+		failures += check_ptr(deque_peek_bottom(d, i), m->items[i]);
+	}
+	return failures;
+}
+
+/* random inserts and erases in the middle, and at both ends */
+unsigned test_insert_erase_compare(unsigned options, size_t len)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	struct model m;
+	uint32_t x = 2463534242UL;
+	size_t i, j, k, n = 0, removed = 0;
+	uintptr_t divisor = 0;
+
+	d = deque_init_options(NULL, NULL, len, NULL, options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	m.len = 0;
+
+	for (i = 0; i < 20000 && !failures; ++i) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		j = m.len ? ((x >> 8) % (m.len + 1)) : 0;
+		switch (x % 8) {
+		case 0:
+		case 1:
+		case 2:
+		case 3:
+			if (m.len == Model_max) {
+				break;
+			}
+			failures += check_ptr(deque_insert_at(d, j, item(n)), d);
+			eembed_memmove(m.items + j + 1, m.items + j,
+				       sizeof(void *) * (m.len - j));
+			m.items[j] = item(n++);
+			++m.len;
+			break;
+		case 4:
+		case 5:
+			if (j == m.len) {
+				failures +=
+				    check_ptr(deque_erase_at(d, j), NULL);
+				break;
+			}
+			failures += check_ptr(deque_erase_at(d, j), m.items[j]);
+			--m.len;
+			eembed_memmove(m.items + j, m.items + j + 1,
+				       sizeof(void *) * (m.len - j));
+			break;
+		case 6:
+			k = j + ((x >> 20) % 8);
+			removed = (k > m.len) ? (m.len - j) : (k - j);
+			failures +=
+			    check_size_t(deque_erase_range(d, j, k), removed);
+			eembed_memmove(m.items + j, m.items + j + removed,
+				       sizeof(void *) * (m.len - (j + removed)));
+			m.len -= removed;
+			break;
+		default:
+			/* remove an occasional multiple */
+			divisor = 7 + ((x >> 16) % 32);
+			removed = 0;
+			for (j = 0, k = 0; j < m.len; ++j) {
+				if (((uintptr_t)m.items[j]) % divisor) {
+					m.items[k++] = m.items[j];
+				}
+			}
+			removed = m.len - k;
+			m.len = k;
+			failures +=
+			    check_size_t(deque_remove_if(d, is_multiple,
+							 &divisor), removed);
+			break;
+		}
+		failures += check_model(d, &m);
+	}
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_insert_erase_edges(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	size_t i, calls = 0;
+
+	d = deque_init_options(NULL, NULL, 8, NULL, options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	failures += check_ptr(deque_insert_at(d, 1, item(0)), NULL);
+	failures += check_ptr(deque_erase_at(d, 0), NULL);
+	failures += check_size_t(deque_erase_range(d, 0, 10), 0);
+	failures += check_size_t(deque_remove_if(d, is_odd, &calls), 0);
+	failures += check_size_t(calls, 0);
+
+	/* insert at both ends is the same as push and unshift */
+	failures += check_ptr(deque_insert_at(d, 0, item(1)), d);
+	failures += check_ptr(deque_insert_at(d, 0, item(0)), d);
+	failures += check_ptr(deque_insert_at(d, 2, item(2)), d);
+	for (i = 0; i < 3; ++i) {
+		failures += check_ptr(deque_peek_bottom(d, i), item(i));
+	}
+
+	failures += check_size_t(deque_erase_range(d, 2, 1), 0);
+	failures += check_size_t(deque_erase_range(d, 0, 100), 3);
+	failures += check_size_t(deque_size(d), 0);
+
+	/* items 1 to 20: the odd ones are removed */
+	for (i = 0; i < 20; ++i) {
+		deque_push(d, item(i));
+	}
+	failures += check_size_t(deque_remove_if(d, is_odd, &calls), 10);
+	failures += check_size_t(calls, 20);
+	for (i = 0; i < 10; ++i) {
+		failures += check_ptr(deque_peek_bottom(d, i), item(1 + 2 * i));
+	}
+	failures += check_ptr(deque_pop(d), item(19));
+	failures += check_ptr(deque_shift(d), item(1));
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_insert_out_of_memory(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct deque *d = NULL;
+	size_t i, len;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+
+	d = deque_new_custom_allocator(&wrap);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	len = deque_capacity(d);
+	for (i = 0; i < len; ++i) {
+		deque_unshift(d, item(len - (i + 1)));
+	}
+	failures += check_size_t(deque_capacity(d), len);
+
+	ctx.attempts = 0;
+	ctx.attempts_to_fail_bitmask = 0x01;
+	failures += check_ptr(deque_insert_at(d, 3, item(99)), NULL);
+	failures += check_size_t(deque_size(d), len);
+	for (i = 0; i < len; ++i) {
+		failures += check_ptr(deque_peek_bottom(d, i), item(i));
+	}
+
+	ctx.attempts_to_fail_bitmask = 0;
+	failures += check_ptr(deque_insert_at(d, 3, item(99)), d);
+	failures += check_ptr(deque_peek_bottom(d, 3), item(99));
+	failures += check_ptr(deque_peek_bottom(d, 4), item(3));
+	failures += check_size_t(deque_size(d), len + 1);
+
+	deque_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+
+	return failures;
+}
+
+unsigned test_insert_erase(void)
+{
+	unsigned failures = 0;
+
+	failures += test_insert_erase_compare(0, 0);
+	failures += test_insert_erase_compare(0, 4);
+	failures += test_insert_erase_compare(Deque_option_ring, 0);
+	failures += test_insert_erase_compare(Deque_option_ring, 5);
+	failures += test_insert_erase_edges(0);
+	failures += test_insert_erase_edges(Deque_option_ring);
+	failures += test_insert_out_of_memory();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_insert_erase)
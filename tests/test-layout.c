@@ -0,0 +1,119 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-layout.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+#include <stddef.h>
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+#define is_aligned(p) ((((uintptr_t)(p)) % Deque_cache_line) ? 0 : 1)
+
+unsigned test_hot_fields(void)
+{
+	unsigned failures = 0;
+	size_t hot_end = offsetof(struct deque, all_flags) + sizeof(uintptr_t);
+	struct deque d;
+
+	/* the fields of push, pop, shift, and unshift are first */
+	failures += check_size_t(offsetof(struct deque, first_pos), 0);
+	failures += check_int(offsetof(struct deque, end_pos) < hot_end, 1);
+	failures += check_int(offsetof(struct deque, data_space) < hot_end, 1);
+	failures += check_int(offsetof(struct deque, data_space_len) < hot_end,
+			      1);
+	failures += check_int(offsetof(struct deque, ea) >= hot_end, 1);
+	failures += check_int(offsetof(struct deque, policy) >= hot_end, 1);
+	failures += check_int(hot_end <= 48 ? 1 : 0, 1);
+
+	/* the flags still fit in one word */
+	failures += check_int(sizeof(d.flags) <= sizeof(uintptr_t) ? 1 : 0, 1);
+	failures += check_size_t(sizeof(struct deque), 8 * sizeof(void *));
+
+	return failures;
+}
+
+unsigned test_aligned(unsigned options)
+{
+	unsigned failures = 0;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct deque *d = NULL;
+	void *buf[4];
+	size_t i, wrong = 0;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+
+	d = deque_init_options(NULL, NULL, 0, &wrap,
+			       options | Deque_option_aligned);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	/* the struct too, thus the hot fields are in one line */
+	failures += check_int(is_aligned(d), 1);
+	failures += check_int(is_aligned(d->data_space), 1);
+	failures += check_int(d->data_space != (void **)(d + 1) ? 1 : 0, 1);
+	failures += check_size_t(deque_capacity(d), Deque_default_len);
+
+	for (i = 0; i < 10 * Deque_default_len; ++i) {
+		if (i % 2) {
+			deque_push(d, item(i));
+		} else {
+			deque_unshift(d, item(i));
+		}
+		wrong += !is_aligned(d->data_space);
+	}
+	failures += check_size_t(wrong, 0);
+	for (i = 0; i < 9 * Deque_default_len; ++i) {
+		deque_pop(d);
+	}
+	failures += check_ptr(deque_shrink_to_fit(d), d);
+	failures += check_int(is_aligned(d->data_space), 1);
+	failures += check_size_t(deque_capacity(d), Deque_default_len);
+	for (i = 0; i < deque_size(d); ++i) {
+		wrong += (deque_peek_bottom(d, i) == NULL);
+	}
+	failures += check_size_t(wrong, 0);
+	deque_free(d);
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures += check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes,
+					 "bytes");
+
+	/* a caller's data_space, once outgrown, is replaced by an aligned
+	   one */
+	d = deque_init_options(NULL, buf, 4, &wrap,
+			       options | Deque_option_aligned);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_int(is_aligned(d), 1);
+	for (i = 0; i < 20; ++i) {
+		deque_push(d, item(i));
+	}
+	failures += check_int(is_aligned(d->data_space), 1);
+	failures += check_ptr(deque_peek_bottom(d, 0), item(0));
+	failures += check_ptr(deque_peek_top(d, 0), item(19));
+	deque_free(d);
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+
+	return failures;
+}
+
+unsigned test_layout(void)
+{
+	unsigned failures = 0;
+
+	failures += test_hot_fields();
+	failures += test_aligned(0);
+	failures += test_aligned(Deque_option_ring);
+	failures += test_aligned(Deque_option_no_scrub);
+	failures += test_aligned(Deque_option_secure_scrub);
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_layout)
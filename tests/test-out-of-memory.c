@@ -35,7 +35,8 @@ unsigned test_out_of_memory_push(unsigned long malloc_fail_bitmask)
 		goto end_test_out_of_memory;
 	}
 
-	for (i = 0; i < 5; ++i) {
+	/* enough to grow the data_space out of the struct, and again */
+	for (i = 0; i < 200; ++i) {
 		rv = deque_push(d, NULL);
 		if (!rv) {
 			++err;
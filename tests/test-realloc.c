@@ -0,0 +1,187 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-realloc.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+unsigned check_sequence(struct deque *d, size_t first, size_t len,
+			const char *msg)
+{
+	unsigned failures = 0;
+	size_t i;
+
+	failures += check_size_t_m(deque_size(d), len, msg);
+	for (i = 0; i < len; ++i) {
+		failures += check_ptr_m(deque_peek_bottom(d, i),
+					(void *)(uintptr_t)(first + i), msg);
+	}
+	return failures;
+}
+
+/* push values first .. first+len-1 after moving the ring start; the
+   struct is the caller's, thus the data_space is allocated on its own,
+   not inline, and is grown with realloc */
+struct deque *ring_at(struct deque *s, struct eembed_allocator *ea,
+		      size_t start, size_t first, size_t len)
+{
+	struct deque *d;
+	size_t i;
+
+	d = deque_init_options(s, NULL, 8, ea, Deque_option_ring);
+	if (!d) {
+		return NULL;
+	}
+	for (i = 0; i < start; ++i) {
+		deque_push(d, NULL);
+	}
+	for (i = 0; i < start; ++i) {
+		deque_shift(d);
+	}
+	for (i = 0; i < len; ++i) {
+		deque_push(d, (void *)(uintptr_t)(first + i));
+	}
+	return d;
+}
+
+unsigned test_realloc_wrapped_ring(void)
+{
+	unsigned failures = 0;
+	struct deque s;
+	struct deque *d = NULL;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator wrap;
+	struct eembed_allocator *real = eembed_global_allocator;
+	struct eembed_log *elog = eembed_err_log;
+	size_t start;
+
+	echeck_err_injecting_allocator_init(&wrap, real, &ctx, elog);
+
+	/* few wrapped items, and many wrapped items */
+	for (start = 0; start < 8; ++start) {
+		d = ring_at(&s, &wrap, start, 1, 8);
+		if (!d) {
+			check_int(d != NULL ? 1 : 0, 1);
+			return 1;
+		}
+		failures += check_sequence(d, 1, 8, "full ring");
+
+		/* a failed realloc leaves the deque as it was */
+		ctx.attempts_to_fail_bitmask = ~0UL;
+		failures += check_ptr(deque_push(d, (void *)(uintptr_t)9),
+				      NULL);
+		failures += check_size_t(deque_capacity(d), 8);
+		failures += check_sequence(d, 1, 8, "ring oom");
+		ctx.attempts_to_fail_bitmask = 0;
+
+		failures += check_ptr(deque_push(d, (void *)(uintptr_t)9), d);
+		failures += check_sequence(d, 1, 9, "ring grown");
+		failures += check_ptr(deque_unshift(d, NULL), d);
+		failures += check_ptr(deque_shift(d), NULL);
+
+		/* grow by less than double */
+		failures += check_ptr(deque_reserve(d, 0, 40), d);
+		failures += check_size_t(deque_capacity(d), 49);
+		failures += check_sequence(d, 1, 9, "ring reserved");
+
+		deque_free(d);
+	}
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+unsigned test_realloc_linear(void)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator wrap;
+	struct eembed_allocator *real = eembed_global_allocator;
+	struct eembed_log *elog = eembed_err_log;
+	size_t i;
+
+	echeck_err_injecting_allocator_init(&wrap, real, &ctx, elog);
+
+	d = deque_init_options(NULL, NULL, 4, &wrap, 0);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	for (i = 0; i < 100; ++i) {
+		deque_push(d, (void *)(uintptr_t)(101 + i));
+		deque_unshift(d, (void *)(uintptr_t)(100 - i));
+	}
+	failures += check_sequence(d, 1, 200, "linear grown");
+
+	ctx.attempts_to_fail_bitmask = ~0UL;
+	failures += check_ptr(deque_reserve(d, 1000, 1000), NULL);
+	failures += check_sequence(d, 1, 200, "linear oom");
+	ctx.attempts_to_fail_bitmask = 0;
+
+	for (i = 0; i < 150; ++i) {
+		deque_pop(d);
+	}
+	failures += check_ptr(deque_shrink_to_fit(d), d);
+	failures += check_size_t(deque_capacity(d), 50);
+	failures += check_sequence(d, 1, 50, "linear shrunk");
+
+	deque_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+/* an allocator without realloc still grows via malloc, copy, free */
+unsigned test_no_realloc_fallback(void)
+{
+	unsigned failures = 0;
+	struct deque s;
+	struct deque *d = NULL;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator wrap;
+	struct eembed_allocator *real = eembed_global_allocator;
+	struct eembed_log *elog = eembed_err_log;
+	size_t i;
+
+	echeck_err_injecting_allocator_init(&wrap, real, &ctx, elog);
+	wrap.realloc = NULL;
+
+	d = ring_at(&s, &wrap, 5, 1, 8);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	for (i = 9; i <= 100; ++i) {
+		deque_push(d, (void *)(uintptr_t)i);
+	}
+	failures += check_sequence(d, 1, 100, "fallback");
+
+	deque_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+unsigned test_realloc(void)
+{
+	unsigned failures = 0;
+
+	failures += test_realloc_wrapped_ring();
+	failures += test_realloc_linear();
+	failures += test_no_realloc_fallback();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_realloc)
@@ -0,0 +1,103 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-reserve.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+unsigned test_reserve_options(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator wrap;
+	struct eembed_allocator *real = eembed_global_allocator;
+	struct eembed_log *elog = eembed_err_log;
+	size_t i, allocs, capacity;
+
+	echeck_err_injecting_allocator_init(&wrap, real, &ctx, elog);
+
+	d = deque_init_options(NULL, NULL, 8, &wrap, options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_size_t(deque_capacity(d), 8);
+
+	deque_push(d, "x");
+	deque_push(d, "y");
+
+	failures += check_ptr(deque_reserve(d, 100, 200), d);
+	failures += check_int_m(deque_capacity(d) >= 302, 1, "capacity");
+	failures += check_size_t(deque_size(d), 2);
+
+	allocs = ctx.allocs;
+	capacity = deque_capacity(d);
+	for (i = 0; i < 100; ++i) {
+		deque_unshift(d, "front");
+	}
+	for (i = 0; i < 200; ++i) {
+		deque_push(d, "back");
+	}
+	failures += check_size_t_m(ctx.allocs, allocs, "no allocs");
+	failures += check_size_t_m(deque_capacity(d), capacity, "same");
+	failures += check_str((const char *)deque_peek_bottom(d, 100), "x");
+	failures += check_str((const char *)deque_peek_bottom(d, 101), "y");
+
+	/* already enough room */
+	deque_clear(d);
+	failures += check_ptr(deque_reserve(d, 10, 10), d);
+	failures += check_size_t_m(ctx.allocs, allocs, "no allocs 2");
+
+	/* a failed allocation leaves the deque as it was */
+	deque_push(d, "z");
+	ctx.attempts_to_fail_bitmask = ~0UL;
+	failures += check_ptr(deque_reserve(d, 0, 10000), NULL);
+	failures += check_size_t(deque_capacity(d), capacity);
+	failures += check_str((const char *)deque_peek_top(d, 0), "z");
+	ctx.attempts_to_fail_bitmask = 0;
+
+	deque_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+unsigned test_reserve_no_allocator(void)
+{
+	unsigned failures = 0;
+	unsigned char bytes[200];
+	struct deque *d = NULL;
+	size_t capacity;
+
+	d = deque_new_no_allocator(bytes, sizeof(bytes));
+	if (!d) {
+		check_int(0, 1);
+		return 1;
+	}
+	capacity = deque_capacity(d);
+
+	failures += check_ptr(deque_reserve(d, capacity, 1), NULL);
+	failures += check_ptr(deque_reserve(d, capacity / 2, capacity / 2), d);
+	failures += check_size_t(deque_capacity(d), capacity);
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_reserve(void)
+{
+	unsigned failures = 0;
+
+	failures += test_reserve_options(0);
+	failures += test_reserve_options(Deque_option_ring);
+	failures += test_reserve_no_allocator();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_reserve)
@@ -0,0 +1,169 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-ring.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+int concat_each(struct deque *d, void *each, void *context)
+{
+	char *buf = (char *)context;
+	(void)d;
+	eembed_strcat(buf, (const char *)each);
+	return 0;
+}
+
+unsigned test_ring_queue_does_not_allocate(void)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator wrap;
+	struct eembed_allocator *real = eembed_global_allocator;
+	struct eembed_log *elog = eembed_err_log;
+	size_t i, allocs;
+	const char *s;
+	const char *expect[3] = { "a", "b", "c" };
+
+	echeck_err_injecting_allocator_init(&wrap, real, &ctx, elog);
+
+	d = deque_init_options(NULL, NULL, 8, &wrap, Deque_option_ring);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	allocs = ctx.allocs;
+
+	/* steady producer/consumer, wraps many times */
+	deque_push(d, "a");
+	deque_push(d, "b");
+	deque_push(d, "c");
+	for (i = 0; i < 1000; ++i) {
+		deque_push(d, "x");
+		s = (const char *)deque_shift(d);
+		failures += check_str_m(s, i < 3 ? expect[i] : "x", "shift");
+		failures += check_size_t_m(deque_size(d), 3, "size");
+	}
+	failures += check_size_t_m(ctx.allocs, allocs, "no new allocs");
+	failures += check_size_t_m(d->data_space_len, 8, "len");
+
+	/* and the other direction */
+	for (i = 0; i < 1000; ++i) {
+		deque_unshift(d, "y");
+		s = (const char *)deque_pop(d);
+		failures += check_str_m(s, i < 3 ? "x" : "y", "pop");
+	}
+	failures += check_size_t_m(ctx.allocs, allocs, "no new allocs 2");
+
+	deque_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+unsigned test_ring_wrapped_peek_iterate_grow(void)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	char buf[80];
+	int rv;
+
+	d = deque_init_options(NULL, NULL, 4, NULL, Deque_option_ring);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	/* move the head near the end of data_space, then wrap */
+	deque_push(d, "-");
+	deque_push(d, "-");
+	deque_shift(d);
+	deque_shift(d);
+
+	deque_push(d, "b");
+	deque_push(d, "c");
+	deque_push(d, "d");
+	deque_unshift(d, "a");
+
+	failures += check_size_t_m(deque_size(d), 4, "size full");
+	failures += check_size_t_m(d->data_space_len, 4, "not grown");
+
+	failures += check_str_m((char *)deque_peek_bottom(d, 0), "a", "bot 0");
+	failures += check_str_m((char *)deque_peek_bottom(d, 3), "d", "bot 3");
+	failures += check_ptr_m(deque_peek_bottom(d, 4), NULL, "bot 4");
+	failures += check_str_m((char *)deque_peek_top(d, 0), "d", "top 0");
+	failures += check_str_m((char *)deque_peek_top(d, 3), "a", "top 3");
+	failures += check_ptr_m(deque_peek_top(d, 4), NULL, "top 4");
+
+	buf[0] = '\0';
+	rv = deque_for_each(d, concat_each, buf);
+	failures += check_int(rv, 0);
+	failures += check_str(buf, "abcd");
+
+	/* grow while wrapped */
+	deque_push(d, "e");
+	deque_unshift(d, "_");
+	failures += check_size_t_m(d->data_space_len, 8, "grown");
+
+	buf[0] = '\0';
+	deque_for_each(d, concat_each, buf);
+	failures += check_str(buf, "_abcde");
+
+	failures += check_str_m((char *)deque_pop(d), "e", "pop e");
+	failures += check_str_m((char *)deque_shift(d), "_", "shift _");
+	failures += check_str_m((char *)deque_shift(d), "a", "shift a");
+	failures += check_str_m((char *)deque_pop(d), "d", "pop d");
+	failures += check_str_m((char *)deque_pop(d), "c", "pop c");
+	failures += check_str_m((char *)deque_shift(d), "b", "shift b");
+	failures += check_ptr_m(deque_shift(d), NULL, "shift empty");
+	failures += check_ptr_m(deque_pop(d), NULL, "pop empty");
+	failures += check_size_t_m(deque_size(d), 0, "size empty");
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_ring_no_allocator(void)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	unsigned char bytes[200];
+	struct deque *ds = (struct deque *)bytes;
+	void **space = (void **)(bytes + eembed_align(sizeof(struct deque)));
+	size_t len = 3;
+	struct eembed_allocator *nea = eembed_null_allocator;
+
+	d = deque_init_options(ds, space, len, nea, Deque_option_ring);
+	failures += check_ptr(d, ds);
+
+	failures += check_ptr(deque_push(d, "b"), d);
+	failures += check_ptr(deque_unshift(d, "a"), d);
+	failures += check_ptr(deque_push(d, "c"), d);
+	failures += check_ptr_m(deque_push(d, "d"), NULL, "full");
+	failures += check_ptr_m(deque_unshift(d, "z"), NULL, "full");
+
+	failures += check_str((char *)deque_shift(d), "a");
+	failures += check_str((char *)deque_shift(d), "b");
+	failures += check_str((char *)deque_shift(d), "c");
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_ring(void)
+{
+	unsigned failures = 0;
+
+	failures += test_ring_queue_does_not_allocate();
+	failures += test_ring_wrapped_peek_iterate_grow();
+	failures += test_ring_no_allocator();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_ring)
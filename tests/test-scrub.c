@@ -0,0 +1,247 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-scrub.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+#include <stdlib.h>
+
+#define item(i) ((void *)(uintptr_t)((i) + 1))
+
+/* each block is prefixed by its size, thus the free can check that
+   the block was zeroed */
+#define Header_len (2 * sizeof(size_t))
+
+struct scrub_counts {
+	size_t mallocs;
+	size_t callocs;
+	size_t reallocs;
+	size_t frees;
+	size_t dirty_frees;
+};
+
+static void *counting_malloc(struct eembed_allocator *ea, size_t size)
+{
+	struct scrub_counts *counts = (struct scrub_counts *)ea->context;
+	unsigned char *p = (unsigned char *)malloc(Header_len + size);
+
+	if (!p) {
+		return NULL;
+	}
+	++counts->mallocs;
+	*(size_t *)p = size;
+	return p + Header_len;
+}
+
+static void *counting_calloc(struct eembed_allocator *ea, size_t nmemb,
+			     size_t size)
+{
+	struct scrub_counts *counts = (struct scrub_counts *)ea->context;
+	unsigned char *p = NULL;
+
+	p = (unsigned char *)calloc(1, Header_len + (nmemb * size));
+	if (!p) {
+		return NULL;
+	}
+	++counts->callocs;
+	*(size_t *)p = nmemb * size;
+	return p + Header_len;
+}
+
+static void *counting_realloc(struct eembed_allocator *ea, void *ptr,
+			      size_t size)
+{
+	struct scrub_counts *counts = (struct scrub_counts *)ea->context;
+	unsigned char *p = ((unsigned char *)ptr) - Header_len;
+
+	p = (unsigned char *)realloc(p, Header_len + size);
+	if (!p) {
+		return NULL;
+	}
+	++counts->reallocs;
+	*(size_t *)p = size;
+	return p + Header_len;
+}
+
+static void counting_free(struct eembed_allocator *ea, void *ptr)
+{
+	struct scrub_counts *counts = (struct scrub_counts *)ea->context;
+	unsigned char *p = ((unsigned char *)ptr) - Header_len;
+	size_t i, size;
+
+	if (!ptr) {
+		return;
+	}
+	size = *(size_t *)p;
+	for (i = 0; i < size; ++i) {
+		if (p[Header_len + i]) {
+			++counts->dirty_frees;
+			break;
+		}
+	}
+	++counts->frees;
+	free(p);
+}
+
+static void counting_init(struct eembed_allocator *ea,
+			  struct scrub_counts *counts)
+{
+	eembed_memset(counts, 0x00, sizeof(struct scrub_counts));
+	eembed_memset(ea, 0x00, sizeof(struct eembed_allocator));
+	ea->context = counts;
+	ea->malloc = counting_malloc;
+	ea->calloc = counting_calloc;
+	ea->realloc = counting_realloc;
+	ea->free = counting_free;
+}
+
+unsigned test_scrub_default(void)
+{
+	unsigned failures = 0;
+	struct deque d;
+	void *buf[8];
+	size_t i;
+
+	for (i = 0; i < 8; ++i) {
+		buf[i] = item(100 + i);
+	}
+	deque_init(&d, buf, 8, NULL);
+	for (i = 0; i < 8; ++i) {
+		failures += check_ptr(buf[i], NULL);
+	}
+	deque_push(&d, item(1));
+	deque_push(&d, item(2));
+	deque_unshift(&d, item(0));
+	failures += check_ptr(deque_pop(&d), item(2));
+	failures += check_ptr(buf[d.end_pos], NULL);
+	failures += check_ptr(deque_shift(&d), item(0));
+	failures += check_ptr(buf[d.first_pos - 1], NULL);
+	deque_free(&d);
+	for (i = 0; i < 8; ++i) {
+		failures += check_ptr(buf[i], NULL);
+	}
+
+	return failures;
+}
+
+unsigned test_no_scrub(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator ea;
+	struct scrub_counts counts;
+	struct deque d;
+	struct deque *dp = NULL;
+	void *buf[8];
+	void *out[4];
+	size_t i;
+
+	/* the caller's buffer is left as it was */
+	for (i = 0; i < 8; ++i) {
+		buf[i] = item(100 + i);
+	}
+	deque_init_options(&d, buf, 8, NULL, Deque_option_no_scrub);
+	failures += check_ptr(buf[7], item(107));
+	deque_push(&d, item(1));
+	deque_push(&d, item(2));
+	failures += check_ptr(deque_pop(&d), item(2));
+	failures += check_ptr(buf[d.end_pos], item(2));
+	failures += check_ptr(deque_shift(&d), item(1));
+	deque_free(&d);
+	failures += check_ptr(buf[7], item(107));
+
+	/* not zeroed by calloc, nor by the bulk or middle removals */
+	counting_init(&ea, &counts);
+	dp = deque_init_options(NULL, NULL, 16, &ea, Deque_option_no_scrub);
+	if (!dp) {
+		check_int(dp != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	/* the struct and the data_space are one block */
+	failures += check_size_t(counts.mallocs, 1);
+	failures += check_size_t(counts.callocs, 0);
+	for (i = 0; i < 10; ++i) {
+		deque_push(dp, item(i));
+	}
+	failures += check_size_t(deque_pop_n(dp, out, 2), 2);
+	failures += check_size_t(deque_shift_n(dp, out, 2), 2);
+	failures += check_ptr(deque_erase_at(dp, 3), item(5));
+	/* items 0 to 9 were in slots 4 to 13 */
+	failures += check_ptr(dp->data_space[4], item(0));
+	failures += check_ptr(dp->data_space[5], item(1));
+	failures += check_ptr(dp->data_space[11], item(7));
+	failures += check_ptr(dp->data_space[12], item(8));
+	failures += check_ptr(dp->data_space[13], item(9));
+	deque_free(dp);
+	failures += check_size_t(counts.frees, 1);
+	failures += check_size_t(counts.dirty_frees, 1);
+
+	return failures;
+}
+
+unsigned test_secure_scrub(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator ea;
+	struct scrub_counts counts;
+	struct deque *d = NULL;
+	void *buf[8];
+	size_t i;
+
+	/* every data_space, and the struct, is zeroed before it is freed,
+	   even on growth, which therefore does not use realloc */
+	counting_init(&ea, &counts);
+	d = deque_init_options(NULL, NULL, 4, &ea,
+			       Deque_option_secure_scrub
+			       | Deque_option_no_scrub);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	failures += check_int(d->flags.no_scrub, 0);
+	for (i = 0; i < 100; ++i) {
+		deque_push(d, item(i));
+	}
+	failures += check_int(counts.frees > 2 ? 1 : 0, 1);
+	failures += check_size_t(counts.reallocs, 0);
+	failures += check_ptr(deque_shift(d), item(0));
+	deque_free(d);
+	failures += check_size_t(counts.dirty_frees, 0);
+	failures += check_size_t(counts.frees, counts.mallocs + counts.callocs);
+
+	/* and a deque_clear zeroes the items */
+	for (i = 0; i < 8; ++i) {
+		buf[i] = item(100 + i);
+	}
+	d = deque_init_options(NULL, buf, 8, NULL, Deque_option_secure_scrub);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	deque_push(d, item(1));
+	deque_unshift(d, item(0));
+	deque_clear(d);
+	for (i = 0; i < 8; ++i) {
+		failures += check_ptr(buf[i], NULL);
+	}
+	deque_push(d, item(2));
+	deque_free(d);
+	for (i = 0; i < 8; ++i) {
+		failures += check_ptr(buf[i], NULL);
+	}
+
+	return failures;
+}
+
+unsigned test_scrub(void)
+{
+	unsigned failures = 0;
+
+	failures += test_scrub_default();
+	failures += test_no_scrub();
+	failures += test_secure_scrub();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_scrub)
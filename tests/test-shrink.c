@@ -0,0 +1,177 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-shrink.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+unsigned test_shrink_to_fit(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator wrap;
+	struct eembed_allocator *real = eembed_global_allocator;
+	struct eembed_log *elog = eembed_err_log;
+	size_t i;
+
+	echeck_err_injecting_allocator_init(&wrap, real, &ctx, elog);
+
+	d = deque_init_options(NULL, NULL, 0, &wrap, options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	for (i = 0; i < 1000; ++i) {
+		deque_push(d, (void *)(uintptr_t)(i + 1));
+	}
+	for (i = 0; i < 990; ++i) {
+		deque_shift(d);
+	}
+	failures += check_int_m(d->data_space_len > 10, 1, "large");
+
+	/* a failed allocation leaves the deque as it was */
+	ctx.attempts_to_fail_bitmask = ~0UL;
+	failures += check_ptr_m(deque_shrink_to_fit(d), NULL, "oom");
+	failures += check_size_t_m(deque_size(d), 10, "oom size");
+	ctx.attempts_to_fail_bitmask = 0;
+
+	failures += check_ptr(deque_shrink_to_fit(d), d);
+	failures += check_size_t_m(d->data_space_len, 10, "fit");
+	failures += check_size_t_m(deque_size(d), 10, "size");
+	for (i = 0; i < 10; ++i) {
+		failures += check_ptr_m(deque_peek_bottom(d, i),
+					(void *)(uintptr_t)(991 + i), "item");
+	}
+
+	/* still usable at both ends */
+	failures += check_ptr(deque_unshift(d, (void *)(uintptr_t)990), d);
+	failures += check_ptr(deque_push(d, (void *)(uintptr_t)1001), d);
+	failures += check_ptr(deque_shift(d), (void *)(uintptr_t)990);
+	failures += check_ptr(deque_pop(d), (void *)(uintptr_t)1001);
+
+	deque_clear(d);
+	failures += check_ptr(deque_shrink_to_fit(d), d);
+	failures += check_size_t_m(d->data_space_len, 1, "empty fit");
+	failures += check_ptr(deque_push(d, (void *)(uintptr_t)7), d);
+	failures += check_ptr(deque_unshift(d, (void *)(uintptr_t)6), d);
+	failures += check_ptr(deque_shift(d), (void *)(uintptr_t)6);
+
+	deque_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+unsigned test_auto_shrink(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	struct deque_policy policy;
+	struct echeck_err_injecting_context ctx;
+	struct eembed_allocator wrap;
+	struct eembed_allocator *real = eembed_global_allocator;
+	struct eembed_log *elog = eembed_err_log;
+	size_t i, allocs, len;
+
+	echeck_err_injecting_allocator_init(&wrap, real, &ctx, elog);
+
+	eembed_memset(&policy, 0x00, sizeof(struct deque_policy));
+	policy.shrink_divisor = 4;
+	policy.shrink_min_len = 16;
+
+	d = deque_init_options(NULL, NULL, 16, &wrap, options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	deque_set_policy(d, &policy);
+
+	for (i = 0; i < 1024; ++i) {
+		deque_push(d, (void *)(uintptr_t)(i + 1));
+	}
+	len = d->data_space_len;
+	failures += check_int_m(len >= 1024, 1, "grown");
+
+	/* not yet below a quarter */
+	for (i = 0; i < (1024 - (len / 4)); ++i) {
+		deque_shift(d);
+	}
+	failures += check_size_t_m(d->data_space_len, len, "not shrunk");
+
+	deque_shift(d);
+	failures += check_size_t_m(d->data_space_len, len / 2, "shrunk");
+	failures += check_ptr(deque_peek_bottom(d, 0),
+			      (void *)(uintptr_t)(1024 - (len / 4) + 2));
+
+	/* hovering near the boundary must not thrash */
+	allocs = ctx.allocs;
+	for (i = 0; i < 1000; ++i) {
+		deque_push(d, NULL);
+		deque_pop(d);
+		deque_unshift(d, NULL);
+		deque_shift(d);
+	}
+	failures += check_size_t_m(ctx.allocs, allocs, "no thrash");
+
+	/* drain, shrinks down to the minimum, but no further */
+	while (deque_size(d)) {
+		deque_pop(d);
+	}
+	failures += check_size_t_m(d->data_space_len, 16, "min len");
+
+	deque_free(d);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+	failures +=
+	    check_unsigned_int_m(ctx.free_bytes, ctx.alloc_bytes, "bytes");
+
+	return failures;
+}
+
+unsigned test_shrink_no_allocator(void)
+{
+	unsigned failures = 0;
+	unsigned char bytes[200];
+	struct deque *d = NULL;
+	struct deque_policy policy;
+
+	eembed_memset(&policy, 0x00, sizeof(struct deque_policy));
+	policy.shrink_divisor = 4;
+
+	d = deque_new_no_allocator(bytes, sizeof(bytes));
+	if (!d) {
+		check_int(0, 1);
+		return 1;
+	}
+	deque_set_policy(d, &policy);
+
+	deque_push(d, "a");
+	deque_push(d, "b");
+	failures += check_str((const char *)deque_pop(d), "b");
+	failures += check_ptr(deque_shrink_to_fit(d), d);
+	failures += check_str((const char *)deque_pop(d), "a");
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_shrink(void)
+{
+	unsigned failures = 0;
+
+	failures += test_shrink_to_fit(0);
+	failures += test_shrink_to_fit(Deque_option_ring);
+	failures += test_auto_shrink(0);
+	failures += test_auto_shrink(Deque_option_ring);
+	failures += test_shrink_no_allocator();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_shrink)
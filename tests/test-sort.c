@@ -0,0 +1,354 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-sort.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+#define item(i) ((void *)(uintptr_t)(i))
+
+struct job {
+	unsigned deadline;
+	unsigned id;
+};
+
+int by_value(void *a, void *b, void *context)
+{
+	uintptr_t x = (uintptr_t)a;
+	uintptr_t y = (uintptr_t)b;
+
+	if (context) {
+		++*(size_t *)context;
+	}
+	return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+int by_deadline(void *a, void *b, void *context)
+{
+	unsigned x = ((struct job *)a)->deadline;
+	unsigned y = ((struct job *)b)->deadline;
+
+	(void)context;
+	return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+uint32_t xorshift(uint32_t *x)
+{
+	*x ^= *x << 13;
+	*x ^= *x >> 17;
+	*x ^= *x << 5;
+	return *x;
+}
+
+/* a ring of capacity len, with the front moved to the middle, so that
+   most contents will wrap around the end */
+struct deque *half_turned_ring(size_t len)
+{
+	struct deque *d = deque_init_options(NULL, NULL, len, NULL,
+					     Deque_option_ring);
+	if (!d) {
+		return NULL;
+	}
+	while (d->first_pos < len / 2) {
+		deque_push(d, d);
+		deque_shift(d);
+	}
+	return d;
+}
+
+unsigned check_sorted(struct deque *d, uintptr_t expect_sum)
+{
+	unsigned failures = 0;
+	uintptr_t sum = 0, prev = 0, each = 0;
+	size_t i, out_of_order = 0;
+
+	for (i = 0; i < deque_size(d); ++i) {
+		each = (uintptr_t)deque_peek_bottom(d, i);
+		out_of_order += (i && each < prev);
+		sum += each;
+		prev = each;
+	}
+	failures += check_size_t(out_of_order, 0);
+	failures += check_size_t(sum, expect_sum);
+	return failures;
+}
+
+unsigned test_sort_patterns(struct deque *d, size_t n, size_t range)
+{
+	unsigned failures = 0;
+	uint32_t x = 2463534242UL;
+	uintptr_t sum = 0, v = 0;
+	size_t i, pattern, compares = 0;
+
+	for (pattern = 0; pattern < 5; ++pattern) {
+		deque_clear(d);
+		sum = 0;
+		for (i = 0; i < n; ++i) {
+			switch (pattern) {
+			case 0:
+				v = 1 + (xorshift(&x) % range);
+				break;
+			case 1:
+				v = i;
+				break;
+			case 2:
+				v = n - i;
+				break;
+			case 3:
+				v = 7;
+				break;
+			default:
+				/* organ pipe */
+				v = (i < n / 2) ? i : (n - i);
+				break;
+			}
+			sum += v;
+			if (i % 3) {
+				deque_push(d, item(v));
+			} else {
+				deque_unshift(d, item(v));
+			}
+		}
+		compares = 0;
+		deque_sort(d, by_value, &compares);
+		failures += check_sorted(d, sum);
+		/* not quadratic, even for the patterns */
+		if (n > 1000) {
+			failures += check_int(compares < (n * 64) ? 1 : 0, 1);
+		}
+	}
+	return failures;
+}
+
+unsigned test_bounds(void)
+{
+	unsigned failures = 0;
+	struct deque *d = half_turned_ring(32);
+	size_t i, lo, hi;
+
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	/* 0 2 2 2 4 6 6 8 ... wrapped in the ring */
+	for (i = 0; i < 20; ++i) {
+		deque_push(d, item(2 * (i / 2) + ((i == 2) ? 2 : 0)));
+	}
+	deque_sort(d, by_value, NULL);
+
+	for (i = 0; i < 45; ++i) {
+		for (lo = 0; lo < deque_size(d); ++lo) {
+			if ((uintptr_t)deque_peek_bottom(d, lo) >= i) {
+				break;
+			}
+		}
+		for (hi = lo; hi < deque_size(d); ++hi) {
+			if ((uintptr_t)deque_peek_bottom(d, hi) > i) {
+				break;
+			}
+		}
+		failures +=
+		    check_size_t(deque_lower_bound(d, item(i), by_value, NULL),
+				 lo);
+		failures +=
+		    check_size_t(deque_upper_bound(d, item(i), by_value, NULL),
+				 hi);
+	}
+	deque_clear(d);
+	failures += check_size_t(deque_lower_bound(d, item(3), by_value, NULL),
+				 0);
+
+	deque_free(d);
+	return failures;
+}
+
+/* the count of jobs before an earlier deadline, or a lower id with the
+   same deadline */
+size_t jobs_out_of_order(struct deque *d)
+{
+	struct job *prev, *each;
+	size_t i, wrong = 0;
+
+	for (i = 1; i < deque_size(d); ++i) {
+		prev = (struct job *)deque_peek_bottom(d, i - 1);
+		each = (struct job *)deque_peek_bottom(d, i);
+		if (prev->deadline != each->deadline) {
+			wrong += (prev->deadline > each->deadline);
+		} else {
+			wrong += (prev->id > each->id);
+		}
+	}
+	return wrong;
+}
+
+unsigned test_insert_sorted(unsigned options)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL;
+	struct job jobs[200];
+	uint32_t x = 123456789UL;
+	size_t i;
+
+	d = deque_init_options(NULL, NULL, 8, NULL, options);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	for (i = 0; i < 200; ++i) {
+		jobs[i].deadline = xorshift(&x) % 20;
+		jobs[i].id = (unsigned)i;
+		failures += check_ptr(deque_insert_sorted(d, &jobs[i],
+							  by_deadline, NULL),
+				      d);
+	}
+	/* ordered by deadline, and first come first served within that */
+	failures += check_size_t(jobs_out_of_order(d), 0);
+
+	deque_free(d);
+	return failures;
+}
+
+unsigned test_merge(struct deque *dst, struct deque *src)
+{
+	unsigned failures = 0;
+	struct job a[50], b[70];
+	size_t i;
+
+	for (i = 0; i < 50; ++i) {
+		a[i].deadline = (unsigned)(i * 3);
+		a[i].id = (unsigned)i;
+		deque_push(dst, &a[i]);
+	}
+	for (i = 0; i < 70; ++i) {
+		b[i].deadline = (unsigned)(i * 2);
+		b[i].id = (unsigned)(100 + i);
+		deque_push(src, &b[i]);
+	}
+
+	failures += check_ptr(deque_merge(dst, dst, by_deadline, NULL), NULL);
+	failures += check_ptr(deque_merge(dst, src, by_deadline, NULL), dst);
+	failures += check_size_t(deque_size(dst), 120);
+	failures += check_size_t(deque_size(src), 0);
+	failures += check_size_t(jobs_out_of_order(dst), 0);
+	failures += check_ptr(deque_peek_bottom(dst, 0), &a[0]);
+	failures += check_ptr(deque_peek_bottom(dst, 1), &b[0]);
+	failures += check_ptr(deque_peek_top(dst, 0), &a[49]);
+
+	/* nothing to merge */
+	failures += check_ptr(deque_merge(dst, src, by_deadline, NULL), dst);
+	failures += check_size_t(deque_size(dst), 120);
+
+	/* in to an empty deque */
+	failures += check_ptr(deque_merge(src, dst, by_deadline, NULL), src);
+	failures += check_size_t(deque_size(src), 120);
+	failures += check_size_t(deque_size(dst), 0);
+	deque_clear(src);
+
+	return failures;
+}
+
+unsigned test_merge_out_of_memory(void)
+{
+	unsigned failures = 0;
+	struct eembed_allocator wrap;
+	struct echeck_err_injecting_context ctx;
+	struct deque *dst = NULL, *src = NULL;
+	size_t i, len;
+
+	echeck_err_injecting_allocator_init(&wrap, eembed_global_allocator,
+					    &ctx, eembed_err_log);
+
+	dst = deque_new_custom_allocator(&wrap);
+	src = deque_new_custom_allocator(&wrap);
+	if (!dst || !src) {
+		check_int((dst && src) ? 1 : 0, 1);
+		deque_free(dst);
+		deque_free(src);
+		return 1;
+	}
+	len = deque_capacity(dst);
+	/* unshift grows only once full, push may grow before then */
+	for (i = len; i > 0; --i) {
+		deque_unshift(dst, item(2 * (i - 1)));
+		deque_unshift(src, item((2 * (i - 1)) + 1));
+	}
+	failures += check_size_t(deque_capacity(dst), len);
+
+	ctx.attempts = 0;
+	ctx.attempts_to_fail_bitmask = 0x01;
+	failures += check_ptr(deque_merge(dst, src, by_value, NULL), NULL);
+	failures += check_size_t(deque_size(dst), len);
+	failures += check_size_t(deque_size(src), len);
+	failures += check_ptr(deque_peek_top(dst, 0), item(2 * (len - 1)));
+
+	ctx.attempts_to_fail_bitmask = 0;
+	failures += check_ptr(deque_merge(dst, src, by_value, NULL), dst);
+	for (i = 0; i < 2 * len; ++i) {
+		failures += check_ptr(deque_peek_bottom(dst, i), item(i));
+	}
+
+	deque_free(dst);
+	deque_free(src);
+
+	failures += check_unsigned_int_m(ctx.allocs, ctx.frees, "frees,allocs");
+
+	return failures;
+}
+
+unsigned test_sort(void)
+{
+	unsigned failures = 0;
+	struct deque *d = NULL, *src = NULL;
+	size_t sizes[] = { 0, 1, 2, 3, 16, 17, 100, 1000, 20000 };
+	size_t i;
+
+	for (i = 0; i < sizeof(sizes) / sizeof(size_t); ++i) {
+		d = deque_new();
+		if (!d) {
+			check_int(d != NULL ? 1 : 0, 1);
+			return 1;
+		}
+		failures += test_sort_patterns(d, sizes[i], 1000 * 1000);
+		failures += test_sort_patterns(d, sizes[i], 10);
+		deque_free(d);
+	}
+	for (i = 0; i < sizeof(sizes) / sizeof(size_t); ++i) {
+		d = half_turned_ring(sizes[i] ? sizes[i] : 1);
+		if (!d) {
+			check_int(d != NULL ? 1 : 0, 1);
+			return 1;
+		}
+		failures += test_sort_patterns(d, sizes[i], 1000 * 1000);
+		deque_free(d);
+	}
+
+	failures += test_bounds();
+	failures += test_insert_sorted(0);
+	failures += test_insert_sorted(Deque_option_ring);
+
+	d = deque_new();
+	src = half_turned_ring(64);
+	if (!d || !src) {
+		check_int((d && src) ? 1 : 0, 1);
+		deque_free(d);
+		deque_free(src);
+		return 1;
+	}
+	failures += test_merge(d, src);
+	deque_free(d);
+	d = half_turned_ring(64);
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		deque_free(src);
+		return 1;
+	}
+	failures += test_merge(d, src);
+	deque_free(d);
+	deque_free(src);
+
+	failures += test_merge_out_of_memory();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_sort)
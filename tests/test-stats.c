@@ -0,0 +1,214 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* test-stats.c */
+/* Copyright (C) 2026 Eric Herman <eric@freesa.org> */
+
+#include "deque.h"
+#include "echeck.h"
+
+struct hook_log {
+	size_t grows;
+	size_t old_len;
+	size_t new_len;
+	size_t recenters;
+	size_t items_moved;
+};
+
+void log_grow(struct deque *d, size_t old_len, size_t new_len, void *context)
+{
+	struct hook_log *log = (struct hook_log *)context;
+	(void)d;
+	++log->grows;
+	log->old_len = old_len;
+	log->new_len = new_len;
+}
+
+void log_recenter(struct deque *d, size_t items_moved, void *context)
+{
+	struct hook_log *log = (struct hook_log *)context;
+	(void)d;
+	++log->recenters;
+	log->items_moved = items_moved;
+}
+
+/* a linear deque of 8 slots, with 4 items at the end, and 4 free in front */
+struct deque *deque_with_space_in_front(void)
+{
+	struct deque *d = deque_init_options(NULL, NULL, 8, NULL, 0);
+	size_t i;
+
+	if (!d) {
+		return NULL;
+	}
+	for (i = 0; i < 6; ++i) {
+		deque_push(d, d);
+	}
+	deque_shift(d);
+	deque_shift(d);
+	return d;
+}
+
+unsigned test_hooks(void)
+{
+	unsigned failures = 0;
+	struct deque_policy policy;
+	struct hook_log log;
+	struct deque *d;
+
+	eembed_memset(&log, 0x00, sizeof(struct hook_log));
+	eembed_memset(&policy, 0x00, sizeof(struct deque_policy));
+	policy.on_grow = log_grow;
+	policy.on_recenter = log_recenter;
+	policy.hook_context = &log;
+
+	d = deque_with_space_in_front();
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+	deque_set_policy(d, &policy);
+	failures += check_size_t(deque_size(d), 4);
+
+	/* no room at the end, the items are moved toward the front */
+	deque_push(d, d);
+	failures += check_size_t_m(log.recenters, 1, "recenters");
+	failures += check_size_t_m(log.items_moved, 4, "items_moved");
+	failures += check_size_t_m(log.grows, 0, "no grows yet");
+
+	while (deque_capacity(d) == 8) {
+		deque_push(d, d);
+	}
+	failures += check_size_t_m(log.grows, 1, "grows");
+	failures += check_size_t_m(log.old_len, 8, "old_len");
+	failures += check_size_t_m(log.new_len, deque_capacity(d), "new_len");
+
+	/* shrinking is not growing */
+	deque_clear(d);
+	deque_push(d, d);
+	deque_shrink_to_fit(d);
+	failures += check_size_t_m(log.grows, 1, "shrink");
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_stats_counts(void)
+{
+	unsigned failures = 0;
+	struct deque_stats stats;
+	struct deque_stats out;
+	void *items[10];
+	struct deque *d;
+	size_t i;
+
+	eembed_memset(&stats, 0x00, sizeof(struct deque_stats));
+
+	d = deque_with_space_in_front();
+	if (!d) {
+		check_int(d != NULL ? 1 : 0, 1);
+		return 1;
+	}
+
+	failures += check_int_m(deque_stats(d, &out), -1, "not attached");
+	failures += check_size_t(out.pushes, 0);
+
+	if (!deque_set_stats(d, &stats)) {
+		/* built without Deque_stats, nothing is counted */
+		deque_push(d, d);
+		failures += check_int_m(deque_stats(d, &out), -1, "no stats");
+		failures += check_size_t(stats.pushes, 0);
+		deque_free(d);
+		return failures;
+	}
+	/* attaching notes the current size and capacity */
+	failures += check_size_t_m(stats.peak_size, 4, "attach peak_size");
+	failures += check_size_t_m(stats.peak_capacity, 8, "attach peak_cap");
+
+	deque_push(d, d);
+	failures += check_size_t_m(stats.recenters, 1, "recenters");
+	failures += check_size_t_m((size_t)stats.bytes_moved,
+				   4 * sizeof(void *), "bytes_moved");
+	deque_unshift(d, d);
+	deque_pop(d);
+	deque_shift(d);
+	failures += check_size_t_m(stats.peak_size, 6, "peak_size");
+
+	for (i = 0; i < 10; ++i) {
+		items[i] = d;
+	}
+	deque_push_n(d, items, 10);
+	deque_unshift_n(d, items, 2);
+	failures += check_size_t_m(stats.grows, 1, "grows");
+	failures += check_size_t_m(stats.peak_size, 16, "peak_size n");
+	failures += check_size_t_m(stats.peak_capacity, deque_capacity(d),
+				   "peak_capacity");
+	failures += check_size_t_m(deque_pop_n(d, items, 10), 10, "pop_n");
+	failures += check_size_t_m(deque_shift_n(d, items, 10), 6, "shift_n");
+
+	failures += check_int(deque_stats(d, &out), 0);
+	failures += check_size_t_m(out.pushes, 11, "pushes");
+	failures += check_size_t_m(out.pops, 11, "pops");
+	failures += check_size_t_m(out.shifts, 7, "shifts");
+	failures += check_size_t_m(out.unshifts, 3, "unshifts");
+	failures += check_size_t_m(out.shrinks, 0, "shrinks");
+
+	deque_shrink_to_fit(d);
+	failures += check_size_t_m(stats.shrinks, 1, "shrink_to_fit");
+
+	/* detached, the stats are left as they were */
+	deque_set_stats(d, NULL);
+	deque_push(d, d);
+	failures += check_int(deque_stats(d, &out), -1);
+	failures += check_size_t_m(stats.pushes, 11, "detached");
+
+	deque_free(d);
+
+	return failures;
+}
+
+unsigned test_stats_shared(void)
+{
+	unsigned failures = 0;
+	struct deque_stats stats;
+	struct deque *a, *b;
+
+	eembed_memset(&stats, 0x00, sizeof(struct deque_stats));
+
+	a = deque_new();
+	b = deque_init_options(NULL, NULL, 0, NULL, Deque_option_ring);
+	if (!a || !b) {
+		check_int((a && b) ? 1 : 0, 1);
+		deque_free(a);
+		deque_free(b);
+		return 1;
+	}
+
+	if (deque_set_stats(a, &stats) && deque_set_stats(b, &stats)) {
+		deque_push(a, a);
+		deque_push(b, b);
+		deque_unshift(b, b);
+		deque_shift(b);
+		failures += check_size_t(stats.pushes, 2);
+		failures += check_size_t(stats.unshifts, 1);
+		failures += check_size_t(stats.shifts, 1);
+		failures += check_size_t_m(stats.recenters, 0, "ring");
+	}
+
+	deque_free(a);
+	deque_free(b);
+
+	return failures;
+}
+
+unsigned test_stats(void)
+{
+	unsigned failures = 0;
+
+	failures += test_hooks();
+	failures += test_stats_counts();
+	failures += test_stats_shared();
+
+	return failures;
+}
+
+ECHECK_TEST_MAIN(test_stats)